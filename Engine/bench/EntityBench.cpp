@@ -0,0 +1,137 @@
+#include <Core/Entity.h>
+
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <random>
+
+// V8_EntityRegistry microbenchmarks. Run with --benchmark_format=json or
+// --benchmark_out=ecs.json --benchmark_out_format=json for tracked results.
+
+template <uint32_t N>
+struct BenchComponent {
+  float value[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+};
+
+using ComponentTypes = std::make_integer_sequence<uint32_t, 8>;
+
+template <uint32_t... I>
+static void AddComponents(V8_EntityRegistry& registry, V8_Entity entity, uint32_t types, std::integer_sequence<uint32_t, I...>) {
+  ((I < types ? registry.AddComponent<BenchComponent<I>>(entity) : void()), ...);
+}
+
+template <uint32_t... I>
+static float SumComponents(V8_EntityRegistry& registry, V8_Entity entity, uint32_t types, std::integer_sequence<uint32_t, I...>) {
+  float sum = 0.0f;
+  ((I < types ? (void)(sum += registry.GetComponent<BenchComponent<I>>(entity)->value[0]) : void()), ...);
+  return sum;
+}
+
+static void Populate(V8_EntityRegistry& registry, uint32_t count, uint32_t types) {
+  for (uint32_t i = 0; i < count; i++)
+    AddComponents(registry, registry.CreateEntity(), types, ComponentTypes {});
+}
+
+static void BM_CreateEntities(benchmark::State& state) {
+  uint32_t count = static_cast<uint32_t>(state.range(0));
+
+  for (auto _ : state) {
+    V8_EntityRegistry registry;
+    for (uint32_t i = 0; i < count; i++)
+      benchmark::DoNotOptimize(registry.CreateEntity());
+
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// RemoveEntity scans entities_, so destroying everything is quadratic in the entity count
+static void BM_DestroyEntities(benchmark::State& state) {
+  uint32_t count = static_cast<uint32_t>(state.range(0));
+  uint32_t types = static_cast<uint32_t>(state.range(1));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    V8_EntityRegistry registry;
+    Populate(registry, count, types);
+    state.ResumeTiming();
+
+    for (uint32_t i = 0; i < count; i++)
+      registry.RemoveEntity(i);
+
+    state.PauseTiming();
+    registry = {};
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_AddComponent(benchmark::State& state) {
+  uint32_t count = static_cast<uint32_t>(state.range(0));
+  uint32_t types = static_cast<uint32_t>(state.range(1));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    V8_EntityRegistry registry;
+    for (uint32_t i = 0; i < count; i++)
+      registry.CreateEntity();
+    state.ResumeTiming();
+
+    for (uint32_t i = 0; i < count; i++)
+      AddComponents(registry, i, types, ComponentTypes {});
+
+    state.PauseTiming();
+    registry = {};
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * count * types);
+}
+
+// One lookup per iteration at a random entity, so the time is per-call latency
+static void BM_GetComponent(benchmark::State& state) {
+  uint32_t count = static_cast<uint32_t>(state.range(0));
+  uint32_t types = static_cast<uint32_t>(state.range(1));
+
+  V8_EntityRegistry registry;
+  Populate(registry, count, types);
+
+  std::vector<V8_Entity> order(count);
+  std::mt19937 rng(42);
+  for (auto& entity : order)
+    entity = rng() % count;
+
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(registry.GetComponent<BenchComponent<0>>(order[next]));
+    next = next + 1 == order.size() ? 0 : next + 1;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The renderer's access pattern: walk entities_ and fetch each component type
+static void BM_Iterate(benchmark::State& state) {
+  uint32_t count = static_cast<uint32_t>(state.range(0));
+  uint32_t types = static_cast<uint32_t>(state.range(1));
+
+  V8_EntityRegistry registry;
+  Populate(registry, count, types);
+
+  for (auto _ : state) {
+    float sum = 0.0f;
+    for (V8_Entity entity : registry.entities_)
+      sum += SumComponents(registry, entity, types, ComponentTypes {});
+
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_CreateEntities)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DestroyEntities)->ArgsProduct({ { 10000, 30000, 100000 }, { 1, 8 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddComponent)->ArgsProduct({ { 10000, 100000, 1000000 }, { 1, 2, 4, 8 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GetComponent)->ArgsProduct({ { 10000, 100000, 1000000 }, { 1, 8 } });
+BENCHMARK(BM_Iterate)->ArgsProduct({ { 10000, 100000, 1000000 }, { 1, 2, 4, 8 } })->Unit(benchmark::kMillisecond);
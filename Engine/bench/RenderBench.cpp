@@ -0,0 +1,304 @@
+#include <Core/Application.h>
+#include <Scene/Types.h>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cmath>
+
+// Renders synthetic scenes headless for a fixed number of frames and writes
+// CPU phase times, GPU time and draw counters as JSON. Compare two result
+// files with Engine/bench/compare.py.
+
+struct BenchScenario {
+  const char* name;
+  uint32_t uniqueMeshes;
+  uint32_t instancesPerMesh;
+  uint32_t trianglesPerMesh;
+};
+
+static const BenchScenario scenarios[] = {
+  { "unique_meshes",   1000, 1,     512 },
+  { "instanced_mesh",  1,    10000, 512 },
+  { "small_meshes",    100,  1,     128 },
+  { "large_meshes",    100,  1,     32768 },
+};
+
+struct BenchOptions {
+  uint32_t frames = 300;
+  uint32_t warmup = 30;
+  uint32_t width = 1280;
+  uint32_t height = 720;
+  bool renderThread = false;
+  bool meshletCulling = true;
+  std::string shaderDir = "../shaders";
+  std::string outPath;
+  std::vector<std::string> scenarios;
+};
+
+struct BenchResult {
+  const BenchScenario* scenario;
+  std::string device;
+  V8_FrameSummary phases[static_cast<uint32_t>(V8_FramePhase::Count)];
+  V8_FrameSummary gpu;
+  V8_RenderStats stats;
+};
+
+static V8_FrameSummary Summarize(std::vector<double> values) {
+  V8_FrameSummary summary;
+  if (values.empty())
+    return summary;
+
+  std::sort(values.begin(), values.end());
+
+  auto rank = [&](double p) {
+    size_t index = static_cast<size_t>(std::ceil(p * values.size()));
+    return values[std::clamp<size_t>(index, 1, values.size()) - 1];
+  };
+
+  double sum = 0.0;
+  for (double v : values)
+    sum += v;
+
+  summary.mean = sum / values.size();
+  summary.p50 = rank(0.50);
+  summary.p95 = rank(0.95);
+  summary.p99 = rank(0.99);
+  summary.max = values.back();
+  return summary;
+}
+
+// A grid of quads inside one cell of the viewport, so every mesh covers its own pixels
+static void BuildGridMesh(uint32_t triangles, uint32_t cell, uint32_t cellsPerRow, std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+  uint32_t quads = std::max(triangles / 2, 1u);
+  uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(quads))));
+
+  float cellSize = 2.0f / cellsPerRow;
+  float originX = -1.0f + (cell % cellsPerRow) * cellSize;
+  float originY = -1.0f + (cell / cellsPerRow % cellsPerRow) * cellSize;
+  float step = cellSize / columns;
+
+  vertices.clear();
+  indices.clear();
+
+  Vector3 color(0.2f + 0.6f * (cell % 7) / 6.0f, 0.5f, 0.8f);
+  for (uint32_t q = 0; q < quads; q++) {
+    float x = originX + (q % columns) * step;
+    float y = originY + (q / columns) * step;
+    uint32_t base = static_cast<uint32_t>(vertices.size());
+
+    vertices.push_back({ .position = { x, y, 0.0f }, .normal = { 0.0f, 0.0f, 1.0f }, .color = color, .uv = { 0.0f, 0.0f } });
+    vertices.push_back({ .position = { x + step, y, 0.0f }, .normal = { 0.0f, 0.0f, 1.0f }, .color = color, .uv = { 1.0f, 0.0f } });
+    vertices.push_back({ .position = { x + step, y + step, 0.0f }, .normal = { 0.0f, 0.0f, 1.0f }, .color = color, .uv = { 1.0f, 1.0f } });
+    vertices.push_back({ .position = { x, y + step, 0.0f }, .normal = { 0.0f, 0.0f, 1.0f }, .color = color, .uv = { 0.0f, 1.0f } });
+
+    indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
+  }
+}
+
+class BenchApp : public V8_Application {
+  private:
+    const BenchOptions& options_;
+    const BenchScenario& scenario_;
+    BenchResult& result_;
+
+    V8_SceneManager sceneManager_;
+    std::vector<std::shared_ptr<V8_StaticMesh>> meshes_;
+
+    // The grid spans [-1, 1] at z = 0, which a 90 degree view from z = 1 covers vertically
+    V8_Camera camera_ { .position = { 0.0f, 0.0f, 1.0f }, .front = { 0.0f, 0.0f, -1.0f }, .up = { 0.0f, 1.0f, 0.0f }, .right = { 1.0f, 0.0f, 0.0f }, .worldUp = { 0.0f, 1.0f, 0.0f }, .zoom = 90.0f };
+
+    uint32_t frame_ = 0;
+    std::vector<double> gpuTimes_;
+
+    void OnInitPre() override {
+      config_.appName = "V8 Bench";
+      config_.headless = true;
+      config_.enableValidationLayers = false;
+      config_.windowWidth = options_.width;
+      config_.windowHeight = options_.height;
+      config_.maxFrames = options_.warmup + options_.frames;
+      config_.renderThread = options_.renderThread;
+      config_.frameStatsCapacity = options_.frames;
+      config_.frameStatsReportInterval = 0.0;
+
+      renderManager_.PreloadShader(options_.shaderDir + "/vert.spv");
+      renderManager_.PreloadShader(options_.shaderDir + "/frag.spv");
+    }
+
+    void OnInitPost() override {
+      std::string vert = options_.shaderDir + "/vert.spv";
+      std::string frag = options_.shaderDir + "/frag.spv";
+      V8_RenderConfig renderConfig = defaultRenderConfig;
+      if (!options_.meshletCulling)
+        renderConfig.meshletCullShaderPath = nullptr;
+
+      renderManager_.CreateRenderer("bench", vert.c_str(), frag.c_str(), V8_RenderPassDescription::Default(context_.swapchainImageFormat_), renderConfig);
+
+      sceneManager_.AddScene("bench");
+      sceneManager_.BindCamera("bench", &camera_);
+
+      uint32_t cellsPerRow = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(scenario_.uniqueMeshes))));
+      std::vector<V8_Vertex> vertices;
+      std::vector<uint32_t> indices;
+
+      for (uint32_t m = 0; m < scenario_.uniqueMeshes; m++) {
+        BuildGridMesh(scenario_.trianglesPerMesh, m, cellsPerRow, vertices, indices);
+
+        auto mesh = std::make_shared<V8_StaticMesh>();
+        mesh->Init(context_, vertices, indices, false);
+        meshes_.push_back(mesh);
+
+        for (uint32_t i = 0; i < scenario_.instancesPerMesh; i++)
+          sceneManager_.AddComponent<V8_StaticMesh>("bench", sceneManager_.AddEntity("bench"), mesh);
+      }
+
+      context_.stagingRing_.Flush();
+      renderManager_.BindScene("bench", &sceneManager_.GetScene("bench"));
+
+      VkPhysicalDeviceProperties properties;
+      vkGetPhysicalDeviceProperties(context_.physicalDevice_, &properties);
+      result_.device = properties.deviceName;
+    }
+
+    void OnFramePre(double dt) override {
+      // Everything before this is warmup
+      if (frame_ == options_.warmup)
+        frameStats_.Clear();
+    }
+
+    // The render thread is idle here, so the GPU timer can be read in either mode
+    void OnFrameSync() override {
+      // GPU times trail by the frames in flight, so warmup frames are skipped the same way
+      if (frame_++ < options_.warmup)
+        return;
+
+      if (V8_Renderer* renderer = renderManager_.GetRenderer("bench"); renderer != nullptr && renderer->GetGpuTimer().IsSupported())
+        gpuTimes_.push_back(renderer->GetGpuTimer().GetFrameMilliseconds());
+    }
+
+    void OnShutdown() override {
+      for (uint32_t i = 0; i < static_cast<uint32_t>(V8_FramePhase::Count); i++)
+        result_.phases[i] = frameStats_.Summarize(static_cast<V8_FramePhase>(i));
+
+      result_.gpu = Summarize(gpuTimes_);
+      result_.stats = renderManager_.GetTotalStats();
+
+      renderManager_.Shutdown();
+      meshes_.clear();
+    }
+
+  public:
+    BenchApp(const BenchOptions& options, const BenchScenario& scenario, BenchResult& result) : options_(options), scenario_(scenario), result_(result) {}
+};
+
+static void AppendSummary(std::string& out, const char* name, const V8_FrameSummary& s) {
+  fmt::format_to(std::back_inserter(out), "\"{}\": {{\"mean\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}}", name, s.mean, s.p50, s.p95, s.p99, s.max);
+}
+
+static std::string ToJson(const BenchOptions& options, const std::vector<BenchResult>& results) {
+  static const char* phaseNames[] = { "cpu", "update", "record", "submit", "wait", "latency" };
+
+  std::string out;
+  fmt::format_to(std::back_inserter(out), "{{\n  \"frames\": {},\n  \"warmup\": {},\n  \"width\": {},\n  \"height\": {},\n  \"renderThread\": {},\n  \"meshletCulling\": {},\n  \"scenarios\": [",
+      options.frames, options.warmup, options.width, options.height, options.renderThread, options.meshletCulling);
+
+  for (size_t r = 0; r < results.size(); r++) {
+    const BenchResult& result = results[r];
+    const V8_RenderStats& stats = result.stats;
+
+    out += r == 0 ? "\n" : ",\n";
+    fmt::format_to(std::back_inserter(out), "    {{\"name\": \"{}\", \"device\": \"{}\", \"uniqueMeshes\": {}, \"instancesPerMesh\": {}, \"trianglesPerMesh\": {},\n      ",
+        result.scenario->name, result.device, result.scenario->uniqueMeshes, result.scenario->instancesPerMesh, result.scenario->trianglesPerMesh);
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(V8_FramePhase::Count); i++) {
+      AppendSummary(out, phaseNames[i], result.phases[i]);
+      out += ",\n      ";
+    }
+
+    AppendSummary(out, "gpu", result.gpu);
+    fmt::format_to(std::back_inserter(out), ",\n      \"drawCalls\": {}, \"instances\": {}, \"triangles\": {}, \"pipelineBinds\": {}, \"descriptorBinds\": {}, \"bufferBinds\": {}}}",
+        stats.drawCalls, stats.instances, stats.triangles, stats.pipelineBinds, stats.descriptorBinds, stats.bufferBinds);
+  }
+
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+static bool ParseArgs(int argc, char** argv, BenchOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "--frames" && hasValue) {
+      options.frames = std::max(std::stoul(argv[++i]), 1ul);
+    } else if (arg == "--warmup" && hasValue) {
+      options.warmup = std::stoul(argv[++i]);
+    } else if (arg == "--width" && hasValue) {
+      options.width = std::stoul(argv[++i]);
+    } else if (arg == "--height" && hasValue) {
+      options.height = std::stoul(argv[++i]);
+    } else if (arg == "--render-thread") {
+      options.renderThread = true;
+    } else if (arg == "--no-meshlet-culling") {
+      options.meshletCulling = false;
+    } else if (arg == "--shaders" && hasValue) {
+      options.shaderDir = argv[++i];
+    } else if (arg == "--out" && hasValue) {
+      options.outPath = argv[++i];
+    } else if (arg.starts_with("--")) {
+      return false;
+    } else {
+      options.scenarios.push_back(arg);
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!ParseArgs(argc, argv, options)) {
+    std::fprintf(stderr, "usage: %s [--frames N] [--warmup N] [--width W] [--height H] [--render-thread] [--no-meshlet-culling] [--shaders DIR] [--out FILE] [scenario...]\nscenarios:", argv[0]);
+    for (const auto& scenario : scenarios)
+      std::fprintf(stderr, " %s", scenario.name);
+    std::fprintf(stderr, "\n");
+    return 1;
+  }
+
+  std::vector<BenchResult> results;
+  for (const auto& scenario : scenarios) {
+    if (!options.scenarios.empty() && std::find(options.scenarios.begin(), options.scenarios.end(), scenario.name) == options.scenarios.end())
+      continue;
+
+    BenchResult& result = results.emplace_back();
+    result.scenario = &scenario;
+
+    BenchApp app(options, scenario, result);
+    app.Run();
+  }
+
+  if (results.empty()) {
+    std::fprintf(stderr, "no matching scenarios\n");
+    return 1;
+  }
+
+  std::string json = ToJson(options, results);
+  if (options.outPath.empty()) {
+    std::fwrite(json.data(), 1, json.size(), stdout);
+    return 0;
+  }
+
+  std::ofstream file(options.outPath, std::ios::trunc);
+  if (!file.is_open()) {
+    std::fprintf(stderr, "failed to open %s\n", options.outPath.c_str());
+    return 1;
+  }
+
+  file << json;
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include <Core/Context.h>
+#include <Core/Profiler.h>
+#include <Scene/Types.h>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <memory>
+
+// Uploads meshes of several sizes through V8_StaticMesh::Upload on a headless
+// context and reports throughput, submissions and main-thread stall time as
+// JSON. Each mesh is built before timing starts, so only the upload is measured.
+
+enum class UploadMode {
+  Sync,    // flush the staging ring after every mesh, the old wait-idle behaviour
+  Batched  // let batches stay in flight, flush once at the end
+};
+
+struct UploadCase {
+  const char* name;
+  uint32_t meshCount;
+  uint32_t verticesPerMesh;
+};
+
+static const UploadCase cases[] = {
+  { "small",  2000, 1024 },
+  { "medium", 100,  65536 },
+  { "large",  4,    1048576 },
+};
+
+static const uint64_t stagingSizes[] = { 4ull * 1024 * 1024, 64ull * 1024 * 1024 };
+
+struct UploadResult {
+  const UploadCase* uploadCase;
+  UploadMode mode;
+  uint64_t stagingSize;
+  uint64_t bytes;
+  uint64_t submissions;
+  double seconds;
+  double callMilliseconds;  // main thread inside Upload
+  double stallMilliseconds; // main thread blocked on the queue, including the final flush
+};
+
+static void BuildMesh(V8_StaticMesh& mesh, uint32_t vertexCount) {
+  std::vector<V8_Vertex> vertices(vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++)
+    vertices[i] = { .position = { static_cast<float>(i % 1024), static_cast<float>(i / 1024), 0.0f }, .normal = { 0.0f, 0.0f, 1.0f }, .color = { 1.0f, 1.0f, 1.0f }, .uv = { 0.0f, 0.0f } };
+
+  // Triangle list over consecutive vertices, about as many indices as vertices
+  std::vector<uint32_t> indices;
+  indices.reserve(vertexCount);
+  for (uint32_t i = 0; i + 2 < vertexCount; i += 3)
+    indices.insert(indices.end(), { i, i + 1, i + 2 });
+
+  mesh.Build(std::move(vertices), std::move(indices), false);
+}
+
+static UploadResult RunCase(V8_Context& context, const UploadCase& uploadCase, UploadMode mode) {
+  std::vector<std::unique_ptr<V8_StaticMesh>> meshes(uploadCase.meshCount);
+  for (auto& mesh : meshes) {
+    mesh = std::make_unique<V8_StaticMesh>();
+    BuildMesh(*mesh, uploadCase.verticesPerMesh);
+  }
+
+  V8_StagingRing& ring = context.stagingRing_;
+  ring.Flush();
+
+  uint64_t bytes = ring.bytesUploaded_;
+  uint64_t submissions = ring.submissions_;
+  uint64_t stall = ring.stallNanoseconds_;
+  uint64_t inCalls = 0;
+  uint64_t start = V8_Profiler::Now();
+
+  for (auto& mesh : meshes) {
+    uint64_t callStart = V8_Profiler::Now();
+    mesh->Upload(context);
+
+    if (mode == UploadMode::Sync)
+      ring.Flush();
+
+    inCalls += V8_Profiler::Now() - callStart;
+  }
+
+  ring.Flush();
+  uint64_t end = V8_Profiler::Now();
+
+  UploadResult result {};
+  result.uploadCase = &uploadCase;
+  result.mode = mode;
+  result.stagingSize = ring.Capacity();
+  result.bytes = ring.bytesUploaded_ - bytes;
+  result.submissions = ring.submissions_ - submissions;
+  result.seconds = (end - start) / 1e9;
+  result.callMilliseconds = inCalls / 1e6;
+  result.stallMilliseconds = (ring.stallNanoseconds_ - stall) / 1e6;
+  return result;
+}
+
+static std::string ToJson(const std::string& device, const std::vector<UploadResult>& results) {
+  std::string out;
+  fmt::format_to(std::back_inserter(out), "{{\n  \"device\": \"{}\",\n  \"results\": [", device);
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const UploadResult& r = results[i];
+    double megabytes = r.bytes / (1024.0 * 1024.0);
+
+    out += i == 0 ? "\n" : ",\n";
+    fmt::format_to(std::back_inserter(out),
+        "    {{\"case\": \"{}\", \"mode\": \"{}\", \"stagingBytes\": {}, \"meshes\": {}, \"bytes\": {}, \"submissions\": {}, "
+        "\"seconds\": {:.6f}, \"mbPerSecond\": {:.2f}, \"submissionsPerSecond\": {:.2f}, \"uploadCallMs\": {:.3f}, \"stallMs\": {:.3f}}}",
+        r.uploadCase->name, r.mode == UploadMode::Sync ? "sync" : "batched", r.stagingSize, r.uploadCase->meshCount, r.bytes, r.submissions,
+        r.seconds, megabytes / r.seconds, r.submissions / r.seconds, r.callMilliseconds, r.stallMilliseconds);
+  }
+
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+int main(int argc, char** argv) {
+  std::string outPath;
+  for (int i = 1; i < argc; i++) {
+    if (std::string(argv[i]) == "--out" && i + 1 < argc) {
+      outPath = argv[++i];
+    } else {
+      std::fprintf(stderr, "usage: %s [--out FILE]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  std::string device;
+  std::vector<UploadResult> results;
+
+  // The staging ring is sized when the context is created, so each size gets its own context
+  for (uint64_t stagingSize : stagingSizes) {
+    V8_CoreConfig config = defaultConfig;
+    config.appName = "V8 Upload Bench";
+    config.headless = true;
+    config.enableValidationLayers = false;
+    config.stagingBufferSize = stagingSize;
+
+    V8_Context context;
+    context.Init(config);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(context.physicalDevice_, &properties);
+    device = properties.deviceName;
+
+    for (const auto& uploadCase : cases) {
+      results.push_back(RunCase(context, uploadCase, UploadMode::Sync));
+      results.push_back(RunCase(context, uploadCase, UploadMode::Batched));
+    }
+  }
+
+  std::string json = ToJson(device, results);
+  if (outPath.empty()) {
+    std::fwrite(json.data(), 1, json.size(), stdout);
+    return 0;
+  }
+
+  std::ofstream file(outPath, std::ios::trunc);
+  if (!file.is_open()) {
+    std::fprintf(stderr, "failed to open %s\n", outPath.c_str());
+    return 1;
+  }
+
+  file << json;
+  return 0;
+}
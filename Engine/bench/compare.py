@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Compares two V8-bench result files.
+
+    compare.py baseline.json current.json [--threshold 10]
+
+Timings that got slower by more than the threshold percent and draw counters
+that went up are reported as regressions, and the exit status is 1.
+Baselines are only meaningful against results from the same device and
+resolution, record one per CI machine with `V8-bench --out baseline.json`.
+"""
+
+import argparse
+import json
+import sys
+
+TIMINGS = [("cpu", "p50"), ("cpu", "p99"), ("record", "p50"), ("submit", "p50"), ("gpu", "p50"), ("gpu", "p99")]
+COUNTERS = ["drawCalls", "instances", "triangles", "pipelineBinds", "descriptorBinds", "bufferBinds"]
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data, {s["name"]: s for s in data["scenarios"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    base_data, baseline = load(args.baseline)
+    cur_data, current = load(args.current)
+
+    for key in ("width", "height", "renderThread", "meshletCulling"):
+        if base_data.get(key) != cur_data.get(key):
+            print(f"warning: {key} differs ({base_data.get(key)} vs {cur_data.get(key)})")
+
+    regressions = 0
+    for name, cur in current.items():
+        base = baseline.get(name)
+        if base is None:
+            print(f"{name}: not in baseline, skipped")
+            continue
+
+        if base.get("device") != cur.get("device"):
+            print(f"{name}: warning, device differs ({base.get('device')} vs {cur.get('device')})")
+
+        print(name)
+        for phase, stat in TIMINGS:
+            before = base[phase][stat]
+            after = cur[phase][stat]
+
+            # No GPU timestamps on this device
+            if before == 0.0 and after == 0.0:
+                continue
+
+            change = (after - before) / before * 100.0 if before > 0.0 else float("inf")
+            flag = ""
+            if change > args.threshold:
+                flag = "  REGRESSION"
+                regressions += 1
+
+            print(f"  {phase + '.' + stat:<11} {before:9.3f} ms -> {after:9.3f} ms  {change:+7.1f}%{flag}")
+
+        # The scenes are fixed, so more work per frame is a regression regardless of timing noise
+        for counter in COUNTERS:
+            if cur[counter] > base[counter]:
+                print(f"  {counter} {base[counter]} -> {cur[counter]}  REGRESSION")
+                regressions += 1
+            elif cur[counter] < base[counter]:
+                print(f"  {counter} {base[counter]} -> {cur[counter]}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name}: missing from current results")
+
+    if regressions:
+        print(f"{regressions} regression(s), timing threshold {args.threshold:.1f}%")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
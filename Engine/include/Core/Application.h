@@ -1,53 +1,208 @@
 #pragma once
 
 #include <Renderer/RenderManager.h>
+#include <Scene/AssetManager.h>
+#include <Core/FrameAllocator.h>
+#include <Core/MemoryTracker.h>
+#include <Core/FrameLimiter.h>
+#include <Core/ThreadPool.h>
+#include <Core/FrameStats.h>
+#include <Core/Profiler.h>
 #include <Core/Context.h>
+#include <Core/Startup.h>
 
 #include <SDL2/SDL.h>
+#include <future>
+#include <memory>
+#include <cmath>
 
 class V8_Application {
+  private:
+    double fixedAccumulator_ = 0.0;
+
+    // Runs as many fixed steps as dt covers, at most config_.maxFixedSteps so one slow frame
+    // can't snowball into ever more steps. The leftover fraction of a step drives interpolation.
+    void RunFixedUpdates(double dt) {
+      V_PROFILE_SCOPE("Fixed updates");
+
+      double step = 1.0 / config_.fixedUpdateRate;
+      fixedAccumulator_ += dt;
+
+      for (uint32_t i = 0; i < config_.maxFixedSteps && fixedAccumulator_ >= step; i++) {
+        renderManager_.StoreTransforms();
+        OnFixedUpdate(step);
+        fixedAccumulator_ -= step;
+      }
+
+      if (fixedAccumulator_ >= step) {
+        V_DEBUG_LIMITED("Fixed update fell behind, dropping {:.1f} ms of simulation", (fixedAccumulator_ - std::fmod(fixedAccumulator_, step)) * 1000.0);
+        fixedAccumulator_ = std::fmod(fixedAccumulator_, step);
+      }
+
+      renderManager_.SetInterpolation(static_cast<float>(fixedAccumulator_ / step));
+    }
+
   protected:
     V8_CoreConfig config_ = defaultConfig;
     V8_Context context_;
+    V8_AssetManager assetManager_;
 
     V8_RenderManager renderManager_;
+    V8_FrameStats frameStats_;
+    V8_FrameLimiter frameLimiter_;
+
+    // Records and submits frames when config_.renderThread is set
+    std::unique_ptr<V8_ThreadPool> renderThread_;
 
     virtual void OnInitPre() {}
     virtual void OnInitPost() {}
+
+    // Runs on a worker thread while the context is created, for CPU-side loading such as
+    // reading and building meshes. It must not touch context_ or the managers, OnInitPost
+    // runs after it returns.
+    virtual void OnPreload() {}
+
     virtual void OnRawEvent(SDL_Event& e) {}
     virtual void OnFramePre(double dt) {}
+
+    // Called config_.fixedUpdateRate times per second of frame time, with dt fixed at one step.
+    // Mesh transforms are saved before each call and rendered blended between the last two steps.
+    virtual void OnFixedUpdate(double dt) {}
+
+    // Runs on the main thread once the previous frame has been handed to the GPU and before
+    // the next one is extracted. With config_.renderThread, OnFramePre and OnFramePost overlap
+    // recording and may only change scene state such as transforms, cameras and entities.
+    // Removing an entity is fine there, the renderer holds its mesh until the GPU is done with it.
+    // Uploading meshes, binding scenes and reading back images belong here.
+    virtual void OnFrameSync() {}
+
     virtual void OnFramePost(double dt) {}
     virtual void OnShutdown() {}
 
     virtual void InitDefaultResources() {
-    if (SDL_Init(SDL_INIT_VIDEO) != 0) 
-      V_FATAL("Failed to initialize SDL video subsystem: {}", SDL_GetError());
+      // Headless runs still poll events so a quit request ends the run
+      if (SDL_Init(config_.headless ? SDL_INIT_EVENTS : SDL_INIT_VIDEO) != 0) 
+        V_FATAL("Failed to initialize SDL: {}", SDL_GetError());
+
+      startupTimeline.Mark("SDL");
+
+      std::future<void> preload = std::async(std::launch::async, [this] {
+        profiler.SetThreadName("Preload");
+
+        uint64_t start = V8_Profiler::Now();
+        OnPreload();
+        startupTimeline.Record("OnPreload", start, V8_Profiler::Now());
+      });
 
       context_.Init(config_);
+      assetManager_.Init(context_);
       renderManager_.Init(&context_);
+
+      startupTimeline.Mark("Managers");
+
+      preload.get();
+      startupTimeline.Mark("Preload wait");
     }
 
   public:
     void Run() {
+      // Captures from startup so context and resource creation show up in the trace
+      profiler.SetThreadName("Main");
+      profiler.SetEnabled(!config_.profileTracePath.empty());
+
+      startupTimeline.Begin();
+
       OnInitPre();
+      startupTimeline.Mark("OnInitPre");
+
       InitDefaultResources();
+
       OnInitPost();
+      startupTimeline.Mark("OnInitPost");
+
+      frameStats_.Init(config_.frameStatsCapacity, config_.frameStatsReportInterval, config_.frameStatsCsvPath);
 
-      int oldWidth, oldHeight;
-      int newWidth, newHeight;
+      frameLimiter_.Init(config_.targetFrameRate);
+      frameAllocator.Init(static_cast<uint32_t>(context_.swapchainImages_.size()), config_.frameAllocatorBlockSize);
 
-      SDL_GetWindowSize(context_.window_.Get(), &oldWidth, &oldHeight);
-      SDL_GetWindowSize(context_.window_.Get(), &newWidth, &newHeight);
+      if (config_.renderThread)
+        renderThread_ = std::make_unique<V8_ThreadPool>(1, "Render");
 
+      // Low latency mode waits for the GPU first and polls input right after, which a render
+      // thread working on the previous frame would defeat
+      bool lowLatency = config_.lowLatency && renderThread_ == nullptr;
+
+      int oldWidth = config_.windowWidth, oldHeight = config_.windowHeight;
+      int newWidth = config_.windowWidth, newHeight = config_.windowHeight;
+
+      if (!config_.headless) {
+        SDL_GetWindowSize(context_.window_.Get(), &oldWidth, &oldHeight);
+        SDL_GetWindowSize(context_.window_.Get(), &newWidth, &newHeight);
+      }
+
+      uint32_t frameCount = 0;
+      bool firstFrame = true;
+      bool renderPending = false;
       bool running = true;
       Uint64 lastTime = SDL_GetPerformanceCounter();
+
+      auto pollEvents = [&] {
+        V_PROFILE_SCOPE("Events");
+
+        SDL_Event e;
+        while (SDL_PollEvent(&e)) {
+          if (e.type == SDL_QUIT)  running = false;
+
+          OnRawEvent(e);
+        }
+      };
+
       while (running) {
+        V_PROFILE_SCOPE("Frame");
+
+        frameLimiter_.Wait();
+        frameAllocator.BeginFrame();
+
         Uint64 currentTime = SDL_GetPerformanceCounter();
         double dt = (currentTime - lastTime) / (double)SDL_GetPerformanceFrequency();
         lastTime = currentTime;
 
+        V8_FrameSample sample;
+        double renderMilliseconds = 0.0;
+
+        if (lowLatency) {
+          renderManager_.WaitForFrames();
+
+          double waitMilliseconds = (SDL_GetPerformanceCounter() - currentTime) * 1000.0 / SDL_GetPerformanceFrequency();
+          sample[V8_FramePhase::Wait] += waitMilliseconds;
+          renderMilliseconds += waitMilliseconds;
+
+          pollEvents();
+        }
+
         OnFramePre(dt);
 
+        if (config_.fixedUpdateRate != 0)
+          RunFixedUpdates(dt);
+
+        // Sync point, the render thread stays idle from here until the next frame is handed over.
+        // Its timings belong to the frame it just finished.
+        if (renderThread_ != nullptr) {
+          V_PROFILE_SCOPE("Wait for render thread");
+
+          Uint64 waitStart = SDL_GetPerformanceCounter();
+          renderThread_->WaitIdle();
+          renderMilliseconds += (SDL_GetPerformanceCounter() - waitStart) * 1000.0 / SDL_GetPerformanceFrequency();
+
+          if (renderPending)
+            renderManager_.AddFrameTimings(sample);
+
+          renderPending = false;
+        }
+
+        OnFrameSync();
+        assetManager_.Update();
+
         if (context_.needsResize_) {
           V_DEBUG("Window resized");
 
@@ -55,20 +210,47 @@ class V8_Application {
           renderManager_.HandleResize();
 
           context_.needsResize_ = false;
+        } else if (renderThread_ != nullptr) {
+          Uint64 extractStart = SDL_GetPerformanceCounter();
+          renderManager_.ExtractAll();
+          renderMilliseconds += (SDL_GetPerformanceCounter() - extractStart) * 1000.0 / SDL_GetPerformanceFrequency();
+
+          renderThread_->Submit([this] { renderManager_.RenderAllExtracted(); });
+          renderPending = true;
         } else {
+          Uint64 renderStart = SDL_GetPerformanceCounter();
           renderManager_.RenderAll();
+          renderMilliseconds += (SDL_GetPerformanceCounter() - renderStart) * 1000.0 / SDL_GetPerformanceFrequency();
+
+          renderManager_.AddFrameTimings(sample);
         }
 
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-          if (e.type == SDL_QUIT)  running = false;
+        pollEvents();
 
-          OnRawEvent(e);
+        OnFramePost(dt);
+
+        sample[V8_FramePhase::Total] = (SDL_GetPerformanceCounter() - currentTime) * 1000.0 / SDL_GetPerformanceFrequency();
+        sample[V8_FramePhase::Update] = sample[V8_FramePhase::Total] - renderMilliseconds;
+        frameStats_.Add(sample);
+
+        if (firstFrame) {
+          startupTimeline.Mark("First frame");
+          startupTimeline.Report();
+          firstFrame = false;
         }
 
-        OnFramePost(dt);
+        if (config_.maxFrames != 0 && ++frameCount >= config_.maxFrames)
+          running = false;
       }
 
+      renderThread_.reset();
+
       OnShutdown();
+      assetManager_.Shutdown();
+
+      memoryTracker.Report();
+
+      if (!config_.profileTracePath.empty())
+        profiler.WriteChromeTrace(config_.profileTracePath);
     }
 };
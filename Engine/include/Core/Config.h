@@ -33,6 +33,24 @@ struct V8_CoreConfig {
   bool enableVSync;
   bool fullscreen;
   bool resizable;
+  uint64_t stagingBufferSize;
+  uint64_t assetMemoryBudget;
+  uint64_t assetUploadBytesPerFrame;
+  uint32_t assetIOThreads;
+  std::string profileTracePath;
+  uint32_t frameStatsCapacity;
+  double frameStatsReportInterval;
+  std::string frameStatsCsvPath;
+  bool headless;
+  uint32_t maxFrames;
+  std::string pipelineCachePath;
+  bool renderThread;
+  uint32_t fixedUpdateRate;
+  uint32_t maxFixedSteps;
+  double targetFrameRate;
+  bool immediatePresent;
+  bool lowLatency;
+  uint64_t frameAllocatorBlockSize;
 };
 
 extern V8_CoreConfig defaultConfig;
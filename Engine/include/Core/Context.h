@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Core/MemoryTracker.h>
+#include <Core/StagingRing.h>
 #include <Core/Window.h>
 #include <Core/Config.h>
 #include <Core/Logger.h>
@@ -13,16 +15,24 @@ struct V8_Context {
   private:
     void CleanupSwapchain() {
       for (auto imageView : swapchainImageViews_)
-        vkDestroyImageView(device_, imageView, nullptr);
+        vkDestroyImageView(device_, imageView, V8_VulkanAllocator());
 
-      vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+      for (size_t i = 0; i < offscreenAllocations_.size(); i++)
+        vmaDestroyImage(allocator_, swapchainImages_[i], offscreenAllocations_[i]);
+
+      offscreenAllocations_.clear();
+
+      if (swapchain_ != VK_NULL_HANDLE)
+        vkDestroySwapchainKHR(device_, swapchain_, V8_VulkanAllocator());
+
+      swapchain_ = VK_NULL_HANDLE;
     }
 
     void CleanupSyncObjects() {
       for (size_t i = 0; i < swapchainImages_.size(); i++) {
-        vkDestroySemaphore(device_, imageAvailableSemaphores_[i], nullptr);
-        vkDestroySemaphore(device_, renderFinishedSemaphores_[i], nullptr);
-        vkDestroyFence(device_, inFlightFences_[i], nullptr);
+        vkDestroySemaphore(device_, imageAvailableSemaphores_[i], V8_VulkanAllocator());
+        vkDestroySemaphore(device_, renderFinishedSemaphores_[i], V8_VulkanAllocator());
+        vkDestroyFence(device_, inFlightFences_[i], V8_VulkanAllocator());
       }
 
       imageAvailableSemaphores_.clear();
@@ -31,7 +41,11 @@ struct V8_Context {
     }
 
     void CreateSwapchain();
+    void CreateOffscreenImages();
+    void CreateImageViews();
     void CreateSyncObjects();
+    void CreatePipelineCache(const std::vector<char>& data);
+    void SavePipelineCache();
 
   public:
     bool needsResize_ = false;
@@ -47,11 +61,22 @@ struct V8_Context {
     VkQueue graphicsQueue_ = VK_NULL_HANDLE;
     VkQueue presentQueue_ = VK_NULL_HANDLE;
 
+    bool multiDrawIndirect_ = false;
+    bool pipelineStatisticsQuery_ = false;
+
+    // VK_KHR_present_id and VK_KHR_present_wait, never enabled in headless mode
+    bool presentWait_ = false;
+    PFN_vkWaitForPresentKHR waitForPresent_ = nullptr;
+
     uint32_t graphicsQueueFamilyIndex_ = 0;
     uint32_t presentQueueFamilyIndex_ = 0;
 
     VmaAllocator allocator_ = VK_NULL_HANDLE;
 
+    // Shared by every pipeline the engine creates, seeded from config_.pipelineCachePath and written back on destruction.
+    // With the default empty path it only lives in memory.
+    VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+
     VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
     VkFormat swapchainImageFormat_ = VK_FORMAT_UNDEFINED;
     VkExtent2D swapchainExtent_ = {};
@@ -59,8 +84,13 @@ struct V8_Context {
     std::vector<VkImage> swapchainImages_;
     std::vector<VkImageView> swapchainImageViews_;
 
+    // Headless mode renders into these instead of a swapchain, one per swapchain image slot
+    std::vector<VmaAllocation> offscreenAllocations_;
+
     std::unordered_map<uint32_t, VkCommandPool> commandPools_;
 
+    V8_StagingRing stagingRing_;
+
     std::vector<VkSemaphore> imageAvailableSemaphores_;
     std::vector<VkSemaphore> renderFinishedSemaphores_;
     std::vector<VkFence> inFlightFences_;
@@ -72,4 +102,12 @@ struct V8_Context {
     ~V8_Context();
 
     void HandleResize(uint32_t newWidth, uint32_t newHeight);
+
+    bool IsHeadless() const {
+      return config_.headless;
+    }
+
+    // Copies an offscreen image into tightly packed rows of swapchainImageFormat_ texels.
+    // Waits for the graphics queue; layout is the image's layout when the call is made.
+    bool ReadbackImage(uint32_t index, VkImageLayout layout, std::vector<uint8_t>& pixels);
 };
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <Core/MemoryTracker.h>
+#include <Core/PoolAllocator.h>
+
 #include <unordered_map>
 #include <typeindex>
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -13,29 +17,38 @@ using V8_Entity = uint32_t;
 
 struct V8_EntityRegistry {
   std::vector<V8_Entity> entities_;
-  std::unordered_map<V8_Entity, std::unordered_map<std::type_index, std::shared_ptr<void>>> components_;
+  // Map nodes and components come from the pools, so per-entity data stays packed in slabs
+  V8_PooledMap<V8_Entity, V8_PooledMap<std::type_index, std::shared_ptr<void>>> components_;
 
   V8_Entity CreateEntity() {
+    V_MEMORY_SCOPE(V8_MemoryTag::ECS);
+
     V8_Entity entity = entities_.size();
     entities_.push_back(entity);
     return entity;
   }
 
   void RemoveEntity(V8_Entity entity) {
+    V_MEMORY_SCOPE(V8_MemoryTag::ECS);
+
     entities_.erase(std::remove(entities_.begin(), entities_.end(), entity), entities_.end());
     components_.erase(entity);
   }
 
   template<typename T>
   void AddComponent(V8_Entity entity, std::shared_ptr<T> component) {
+    V_MEMORY_SCOPE(V8_MemoryTag::ECS);
+
     std::type_index type = std::type_index(typeid(T));
     components_[entity][type] = component;
   }
 
   template<typename T>
   void AddComponent(V8_Entity entity) {
+    V_MEMORY_SCOPE(V8_MemoryTag::ECS);
+
     std::type_index type = std::type_index(typeid(T));
-    components_[entity][type] = std::make_shared<T>();
+    components_[entity][type] = V8_MakePooled<T>();
   }
 
   template<typename T>
@@ -48,4 +61,16 @@ struct V8_EntityRegistry {
       return nullptr;
     return static_cast<T*>(component->second.get());
   }
+
+  // Shares ownership, for holders that must keep the component alive after the entity is removed
+  template<typename T>
+  std::shared_ptr<T> GetSharedComponent(V8_Entity entity) {
+    auto components = components_.find(entity);
+    if (components == components_.end())
+      return nullptr;
+    auto component = components->second.find(std::type_index(typeid(T)));
+    if (component == components->second.end())
+      return nullptr;
+    return std::static_pointer_cast<T>(component->second);
+  }
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+// Bump allocator for data that only lives until the frames in flight have moved
+// past it. Each thread allocates from its own arena without locking, and each
+// arena has one region per frame in flight. A region is rewound the first time
+// its thread allocates after the region comes around again, so its blocks are
+// allocated up to the high-water mark once and reused every frame after that.
+// Regions follow the frame counter, not the GPU fences, so nothing the GPU reads
+// may live here.
+class V8_FrameAllocator {
+  private:
+    struct Block {
+      std::unique_ptr<std::byte[]> data;
+      size_t size;
+    };
+
+    struct Region {
+      std::vector<Block> blocks;
+      size_t block = 0;
+      size_t offset = 0;
+    };
+
+    struct ThreadArena {
+      std::vector<Region> regions;
+      uint64_t frame = UINT64_MAX;
+      uint32_t region = 0;
+    };
+
+    std::atomic<uint64_t> frame_ { 0 };
+    uint32_t regionCount_ = 2;
+    size_t blockSize_ = 1024 * 1024;
+
+    // Arenas outlive their threads so the thread-local pointers never dangle
+    std::vector<std::unique_ptr<ThreadArena>> arenas_;
+    std::mutex mutex_;
+
+    ThreadArena* LocalArena();
+
+  public:
+    // Call before the first frame. regionCount is the number of frames in flight, at least 2
+    // so the render thread can still read the previous frame's data.
+    void Init(uint32_t regionCount, size_t blockSize);
+
+    // Moves every thread on to the next region, data from regionCount frames ago is dead after this
+    void BeginFrame() {
+      frame_.fetch_add(1, std::memory_order_release);
+    }
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+};
+
+extern V8_FrameAllocator frameAllocator;
+
+// STL allocator over frameAllocator. Containers using it must be rebuilt every frame,
+// they may not carry their storage over to the next one.
+template <typename T>
+struct V8_FrameStlAllocator {
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  V8_FrameStlAllocator() = default;
+
+  template <typename U>
+  V8_FrameStlAllocator(const V8_FrameStlAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(frameAllocator.Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Freed all at once when the region is rewound
+  void deallocate(T*, size_t) {}
+
+  template <typename U>
+  bool operator==(const V8_FrameStlAllocator<U>&) const {
+    return true;
+  }
+};
+
+template <typename T>
+using V8_FrameVector = std::vector<T, V8_FrameStlAllocator<T>>;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Holds the frame loop to a target rate. Sleeps for most of the remaining time
+// and spins the last stretch, since a sleep can wake up late by a scheduler tick.
+class V8_FrameLimiter {
+  private:
+    uint64_t interval_ = 0;
+    uint64_t next_ = 0;
+
+  public:
+    // A targetFrameRate of 0 disables the limiter
+    void Init(double targetFrameRate);
+
+    // Blocks until the next frame is due. A frame that ran more than a whole interval
+    // late restarts the schedule instead of letting the following frames rush to catch up.
+    void Wait();
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class V8_FramePhase : uint32_t {
+  Total,   // whole frame, not counting the frame limiter's sleep
+  Update,  // CPU work outside the renderers
+  Record,  // command recording
+  Submit,  // queue submit and present
+  Wait,    // frame fence and swapchain acquire
+  Latency, // swapchain acquire to on screen for the newest frame shown since the last one, 0 without present wait
+  Count
+};
+
+struct V8_FrameSample {
+  double milliseconds[static_cast<uint32_t>(V8_FramePhase::Count)] = {};
+
+  double& operator[](V8_FramePhase phase) {
+    return milliseconds[static_cast<uint32_t>(phase)];
+  }
+
+  double operator[](V8_FramePhase phase) const {
+    return milliseconds[static_cast<uint32_t>(phase)];
+  }
+};
+
+struct V8_FrameSummary {
+  double mean = 0.0;
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+};
+
+// Keeps the last N frames and summarizes each phase over them. Reports go to
+// the log and optionally to a CSV file, one row per report.
+class V8_FrameStats {
+  private:
+    std::vector<V8_FrameSample> samples_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+
+    double reportInterval_ = 0.0;
+    double sinceReport_ = 0.0;
+    double elapsed_ = 0.0;
+
+    std::ofstream csv_;
+    mutable std::vector<double> scratch_;
+
+    void WriteCsvRow();
+
+  public:
+    // A reportInterval of 0 disables periodic reports, an empty csvPath disables the CSV file
+    void Init(uint32_t capacity, double reportInterval, const std::string& csvPath);
+
+    void Add(const V8_FrameSample& sample);
+    void Clear();
+
+    size_t Count() const {
+      return count_;
+    }
+
+    // Nearest-rank percentiles over the frames currently in the ring
+    V8_FrameSummary Summarize(V8_FramePhase phase) const;
+
+    // Logs one line per phase
+    void Report() const;
+};
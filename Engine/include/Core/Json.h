@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal read-only JSON document, enough for asset formats such as glTF
+struct V8_JsonValue {
+  enum class Type {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<V8_JsonValue> array;
+  std::vector<std::pair<std::string, V8_JsonValue>> object;
+
+  bool IsNull() const { return type == Type::Null; }
+  bool IsArray() const { return type == Type::Array; }
+  bool IsObject() const { return type == Type::Object; }
+
+  size_t Size() const {
+    return type == Type::Array ? array.size() : (type == Type::Object ? object.size() : 0);
+  }
+
+  // Missing keys and out of range indices return a shared null value
+  const V8_JsonValue& operator[](std::string_view key) const;
+  const V8_JsonValue& operator[](size_t index) const;
+
+  bool Has(std::string_view key) const {
+    return !(*this)[key].IsNull();
+  }
+
+  double AsNumber(double fallback = 0.0) const {
+    return type == Type::Number ? number : fallback;
+  }
+
+  int64_t AsInt(int64_t fallback = 0) const {
+    return type == Type::Number ? static_cast<int64_t>(number) : fallback;
+  }
+
+  bool AsBool(bool fallback = false) const {
+    return type == Type::Bool ? boolean : fallback;
+  }
+
+  std::string_view AsString(std::string_view fallback = {}) const {
+    return type == Type::String ? std::string_view(string) : fallback;
+  }
+};
+
+bool V8_ParseJson(std::string_view text, V8_JsonValue& out, std::string* error = nullptr);
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Core/Logger.h>
+
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <mutex>
+
+// One message as handed to sinks. The views are only valid during Append.
+struct V8_LogRecord {
+  V8_Logger::LogLevel level;
+  std::string_view message;
+  bool truncated;
+  std::string_view funcName;
+};
+
+// Destination for formatted log output. The logger thread appends every record
+// of a batch and then calls EndBatch once, so sinks buffer until then and
+// write the whole batch in one go. Calls are serialized by the logger.
+class V8_LogSink {
+  public:
+    virtual ~V8_LogSink() = default;
+
+    virtual void Append(const V8_LogRecord& record) = 0;
+
+    // Writes everything appended since the last batch
+    virtual void EndBatch() = 0;
+
+    // Pushes written data to the device, see V8_Logger::SetFlushInterval
+    virtual void Flush() {}
+};
+
+// Colored text to a stream, std::clog by default
+class V8_ConsoleSink : public V8_LogSink {
+  private:
+    std::ostream* out_;
+    bool color_;
+    std::string buffer_;
+
+  public:
+    V8_ConsoleSink(std::ostream* out = &std::clog, bool color = true) : out_(out), color_(color) {}
+
+    void Append(const V8_LogRecord& record) override;
+    void EndBatch() override;
+    void Flush() override;
+};
+
+// Plain text to path, moved to path.1, path.2, ... once it grows past maxBytes.
+// The oldest file past maxFiles is deleted.
+class V8_RotatingFileSink : public V8_LogSink {
+  private:
+    std::filesystem::path path_;
+    uint64_t maxBytes_;
+    uint32_t maxFiles_;
+    uint64_t size_ = 0;
+    std::ofstream file_;
+    std::string buffer_;
+
+    void Rotate();
+
+  public:
+    V8_RotatingFileSink(const std::filesystem::path& path, uint64_t maxBytes = 16 * 1024 * 1024, uint32_t maxFiles = 4);
+
+    bool IsOpen() const {
+      return file_.is_open();
+    }
+
+    void Append(const V8_LogRecord& record) override;
+    void EndBatch() override;
+    void Flush() override;
+};
+
+// Keeps the most recent output in memory so a crash handler can dump it
+class V8_RingSink : public V8_LogSink {
+  private:
+    std::vector<char> ring_;
+    size_t head_ = 0;
+    bool wrapped_ = false;
+    std::string buffer_;
+    mutable std::mutex mutex_;
+
+  public:
+    explicit V8_RingSink(size_t capacity = 64 * 1024);
+
+    void Append(const V8_LogRecord& record) override;
+    void EndBatch() override;
+
+    // Oldest first, starting at a line boundary. Safe to call from any thread.
+    std::string Contents() const;
+    void Dump(std::ostream& out) const;
+};
@@ -1,11 +1,16 @@
 #pragma once
 
 #include <condition_variable>
+#include <type_traits>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <chrono>
+#include <vector>
 #include <thread>
 #include <atomic>
-#include <queue>
+#include <memory>
 #include <mutex>
 
 #include <fmt/core.h>
@@ -18,7 +23,7 @@
   #define FUNC_NAME __func__
 #endif
 
-static std::string_view TrimArgsFromFunctionName(std::string_view prettyFunc) {
+constexpr std::string_view TrimArgsFromFunctionName(std::string_view prettyFunc) {
     size_t parenPos = prettyFunc.find('(');
     if (parenPos != std::string_view::npos) {
       prettyFunc = prettyFunc.substr(0, parenPos); 
@@ -32,6 +37,190 @@ static std::string_view TrimArgsFromFunctionName(std::string_view prettyFunc) {
     return prettyFunc;
 }
 
+// Numeric values of V8_Logger::LogLevel, for V8_LOG_MIN_LEVEL
+#define V8_LOG_LEVEL_DEBUG 0
+#define V8_LOG_LEVEL_INFO 1
+#define V8_LOG_LEVEL_WARNING 2
+#define V8_LOG_LEVEL_ERROR 3
+#define V8_LOG_LEVEL_FATAL 4
+
+// Calls below this level compile to nothing, fatal errors are always logged
+#ifndef V8_LOG_MIN_LEVEL
+  #ifdef NDEBUG
+    #define V8_LOG_MIN_LEVEL V8_LOG_LEVEL_WARNING
+  #else
+    #define V8_LOG_MIN_LEVEL V8_LOG_LEVEL_DEBUG
+  #endif
+#endif
+
+// Category of the calls in a source file, define it before the first include to change it
+#ifndef V8_LOG_CATEGORY
+  #define V8_LOG_CATEGORY V8_LogCategory::General
+#endif
+
+#ifndef V8_LOG_RATE_LIMIT
+  #define V8_LOG_RATE_LIMIT 10 // messages per second from one _LIMITED call site
+#endif
+
+#ifndef V8_LOG_RATE_BURST
+  #define V8_LOG_RATE_BURST 20 // messages a _LIMITED call site may log at once
+#endif
+
+#ifndef V8_LOG_QUEUE_CAPACITY
+  #define V8_LOG_QUEUE_CAPACITY 4096 // must be a power of two
+#endif
+
+#ifndef V8_LOG_MESSAGE_CAPACITY
+  #define V8_LOG_MESSAGE_CAPACITY 256 // longer messages are truncated
+#endif
+
+#ifndef V8_LOG_MAX_SITES
+  #define V8_LOG_MAX_SITES 4096 // call sites past this log eagerly
+#endif
+
+#ifndef V8_LOG_FLUSH_INTERVAL_MS
+  #define V8_LOG_FLUSH_INTERVAL_MS 200 // default for V8_Logger::SetFlushInterval
+#endif
+
+static_assert((V8_LOG_QUEUE_CAPACITY & (V8_LOG_QUEUE_CAPACITY - 1)) == 0, "V8_LOG_QUEUE_CAPACITY must be a power of two");
+
+#define V8_BINARY_LOG_MAGIC 0x424C3856u // "V8LB"
+#define V8_BINARY_LOG_VERSION 1u
+
+// Binary log layout, little endian, after a u32 magic and u32 version:
+//   Site:    u8 type, u32 id, u8 level, u32 length, format, u32 length, function
+//   Message: u8 type, u32 site, u8 level, u8 truncated, u32 length, payload
+//            and for site 0 (preformatted text) u32 length, function
+enum class V8_BinaryLogRecord : uint8_t {
+  Site = 1,
+  Message = 2
+};
+
+// One bit each so the runtime filter is a single mask test
+enum class V8_LogCategory : uint32_t {
+  General  = 1u << 0,
+  Core     = 1u << 1,
+  Vulkan   = 1u << 2,
+  Renderer = 1u << 3,
+  Scene    = 1u << 4,
+  Assets   = 1u << 5
+};
+
+// Tags of arguments captured by deferred log calls
+enum class V8_LogArgType : uint8_t {
+  Bool,
+  Char,
+  Int,
+  UInt,
+  Double,
+  String,
+  Pointer,
+  Float // appended so binary logs written before it still decode
+};
+
+// Arguments a deferred call can capture as raw bytes. Anything else makes the
+// call format on the calling thread as before.
+template <typename T>
+concept V8_LogCapturable = std::is_arithmetic_v<T> || std::is_pointer_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+// Serializes tagged arguments into a queue slot
+struct V8_LogArgWriter {
+  char* data;
+  uint32_t capacity;
+  uint32_t size = 0;
+  bool truncated = false;
+
+  template <typename T>
+  void Put(V8_LogArgType type, const T& value) {
+    if (size + 1 + sizeof(T) > capacity) {
+      truncated = true;
+      return;
+    }
+
+    data[size] = static_cast<char>(type);
+    std::memcpy(data + size + 1, &value, sizeof(T));
+    size += 1 + sizeof(T);
+  }
+
+  void PutString(std::string_view value) {
+    if (size + 1 + sizeof(uint32_t) > capacity) {
+      truncated = true;
+      return;
+    }
+
+    uint32_t length = static_cast<uint32_t>(std::min<size_t>(value.size(), capacity - size - 1 - sizeof(uint32_t)));
+    truncated |= length < value.size();
+
+    data[size] = static_cast<char>(V8_LogArgType::String);
+    std::memcpy(data + size + 1, &length, sizeof(length));
+    std::memcpy(data + size + 1 + sizeof(length), value.data(), length);
+    size += 1 + sizeof(length) + length;
+  }
+
+  template <typename T>
+  void Write(const T& value) {
+    using D = std::decay_t<T>;
+
+    // Literals and char buffers, bounded by their extent rather than trusted to be terminated
+    if constexpr (std::is_array_v<T>)
+      PutString(std::string_view(value, std::find(value, value + std::extent_v<T>, '\0') - value));
+    else if constexpr (std::is_same_v<D, bool>)
+      Put(V8_LogArgType::Bool, static_cast<uint8_t>(value));
+    else if constexpr (std::is_same_v<D, char>)
+      Put(V8_LogArgType::Char, value);
+    else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>)
+      Put(V8_LogArgType::Int, static_cast<int64_t>(value));
+    else if constexpr (std::is_integral_v<D>)
+      Put(V8_LogArgType::UInt, static_cast<uint64_t>(value));
+    else if constexpr (std::is_same_v<D, float>)
+      Put(V8_LogArgType::Float, value);
+    else if constexpr (std::is_floating_point_v<D>)
+      Put(V8_LogArgType::Double, static_cast<double>(value));
+    else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>)
+      PutString(value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+    else if constexpr (std::is_pointer_v<D>)
+      Put(V8_LogArgType::Pointer, reinterpret_cast<uint64_t>(value));
+    else
+      PutString(std::string_view(value));
+  }
+};
+
+// Token bucket for one call site, kept as the time the bucket would be empty
+// (GCRA) so every thread hitting the site shares a single atomic
+class V8_LogRateLimiter {
+  private:
+    std::atomic<int64_t> emptyAt_ { 0 };
+    std::atomic<uint64_t> suppressed_ { 0 };
+    int64_t interval_;
+    int64_t tolerance_;
+
+  public:
+    V8_LogRateLimiter(double perSecond, uint32_t burst) : interval_(static_cast<int64_t>(1e9 / perSecond)), tolerance_(interval_ * std::max(burst, 1u)) {}
+
+    // False if the site is over its rate. Otherwise suppressed is the number
+    // of messages dropped since the last one that got through.
+    bool Acquire(uint64_t& suppressed) {
+      int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      int64_t emptyAt = emptyAt_.load(std::memory_order_relaxed);
+
+      while (true) {
+        int64_t next = std::max(emptyAt, now) + interval_;
+        if (next - now > tolerance_) {
+          suppressed_.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+
+        if (emptyAt_.compare_exchange_weak(emptyAt, next, std::memory_order_relaxed))
+          break;
+      }
+
+      suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+      return true;
+    }
+};
+
+class V8_LogSink;
+
 class V8_Logger {
   public:
     enum class LogLevel {
@@ -42,62 +231,260 @@ class V8_Logger {
       Fatal
     };
 
+    // What a producer does when the queue is full
+    enum class Backpressure {
+      Drop,      // discard the new message
+      Block,     // wait for the consumer to free a slot
+      Overwrite  // discard the oldest queued message
+    };
+
   private:
+    // Bounded lock-free queue of preallocated slots. A slot's sequence tells
+    // producers and the consumer whose turn it is, so no lock is ever taken
+    // on the logging path.
+    struct Slot {
+      std::atomic<uint64_t> sequence;
+      LogLevel level;
+      bool truncated;
+      uint32_t site;   // 0 for preformatted text, otherwise message holds captured arguments
+      uint32_t length;
+      std::string_view funcName; // call sites pass views of static strings
+      char message[V8_LOG_MESSAGE_CAPACITY];
+    };
+
+    struct Site {
+      LogLevel level;
+      std::string_view format;
+      std::string_view funcName;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> enqueuePos_ { 0 };
+    alignas(64) std::atomic<uint64_t> dequeuePos_ { 0 };
+    alignas(64) std::atomic<uint64_t> dropped_ { 0 };
+    std::atomic<Backpressure> backpressure_ { Backpressure::Drop };
+
+    // levelMasks_[level] holds the categories enabled at that level, rebuilt
+    // from categoryLevels_ and categoryMask_ whenever either changes
+    std::atomic<uint32_t> levelMasks_[V8_LOG_LEVEL_FATAL + 1];
+    LogLevel categoryLevels_[32];
+    uint32_t categoryMask_ = ~0u;
+    std::mutex filterMutex_;
+
+    void UpdateFilter();
+
     std::thread logThread_;
-    std::queue<std::tuple<std::string, std::string, LogLevel>> logQueue_;
-    std::mutex logMutex_;
-    std::condition_variable logCondition_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    std::atomic<bool> consumerSleeping_ { false };
     std::atomic<bool> isRunning_;
 
+    // Sinks and everything written to them are guarded by outputMutex_
+    std::mutex outputMutex_;
+    std::vector<std::shared_ptr<V8_LogSink>> sinks_;
+    std::atomic<int64_t> flushIntervalMs_ { V8_LOG_FLUSH_INTERVAL_MS };
+    uint64_t reportedDrops_ = 0;
+    bool dirty_ = false;
+
+    // Last message written to the sinks, consecutive copies are only counted
+    std::string lastMessage_;
+    std::string_view lastFuncName_;
+    LogLevel lastLevel_ = LogLevel::Debug;
+    bool lastTruncated_ = false;
+    uint64_t repeats_ = 0;
+
+    // Written once per call site, read lock-free by the consumer up to siteCount_
+    std::unique_ptr<Site[]> sites_;
+    std::atomic<uint32_t> siteCount_ { 0 };
+    std::mutex siteMutex_;
+
+    // Consumer thread only, or under outputMutex_
+    std::ofstream binaryLog_;
+    uint32_t binarySitesWritten_ = 0;
+    std::string formatBuffer_;
+
+    void WriteBinary(uint32_t site, LogLevel level, bool truncated, std::string_view payload, std::string_view funcName);
+
+    Slot* AcquireSlot(uint64_t& pos);
+    void PublishSlot(Slot* slot, uint64_t pos);
+    Slot* TryDequeue(uint64_t& pos);
+    void ReleaseSlot(Slot* slot, uint64_t pos);
+
+    // Both require outputMutex_. DrainLocked writes every queued message as one
+    // batch and reports whether it held an error that should be flushed now.
+    size_t DrainLocked(bool& urgent);
+    void FlushLocked();
+    void WriteRecordLocked(LogLevel level, std::string_view message, bool truncated, std::string_view funcName);
+    void WriteRepeatsLocked();
+
     void ProcessQueue();
 
-  public:
-    std::ostream* output_;
+    [[noreturn]] void Fatal(std::string_view funcName, std::string_view message);
 
+  public:
     V8_Logger(std::ostream* out = &std::clog);
     ~V8_Logger();
 
-    void SetOutput(std::ostream* out) {
-      std::unique_lock<std::mutex> lock(logMutex_);
-      output_ = out;
+    // Replaces all sinks with a console sink writing to out
+    void SetOutput(std::ostream* out);
+
+    void AddSink(std::shared_ptr<V8_LogSink> sink);
+    void RemoveSink(const std::shared_ptr<V8_LogSink>& sink);
+
+    // Sinks are flushed at most this long after a write, and immediately for
+    // errors, on Flush, at exit and before a fatal error terminates
+    void SetFlushInterval(std::chrono::milliseconds interval) {
+      flushIntervalMs_.store(interval.count(), std::memory_order_relaxed);
+    }
+
+    // Writes out everything queued so far and flushes the sinks
+    void Flush();
+
+    // Checked by the logging macros before any argument is evaluated
+    bool ShouldLog(LogLevel level, V8_LogCategory category) const {
+      return (levelMasks_[static_cast<int>(level)].load(std::memory_order_relaxed) & static_cast<uint32_t>(category)) != 0;
+    }
+
+    // Minimum level for every category, or for one
+    void SetLevel(LogLevel level);
+    void SetLevel(V8_LogCategory category, LogLevel level);
+
+    // Categories whose bits are clear are not logged at any level below fatal
+    void SetCategoryMask(uint32_t mask);
+
+    void SetBackpressure(Backpressure policy) {
+      backpressure_.store(policy, std::memory_order_relaxed);
+    }
+
+    // Deferred records are written here instead of being formatted; decode them with V8-logdecode
+    bool OpenBinaryLog(const std::string& path);
+    void CloseBinaryLog();
+
+    // Returns 0 once V8_LOG_MAX_SITES is reached, which makes the site log eagerly
+    uint32_t RegisterSite(LogLevel level, std::string_view format, std::string_view funcName);
+
+    // Formats arguments captured by V8_LogArgWriter; false if they were truncated or don't match the format
+    static bool FormatDeferred(std::string& out, std::string_view format, const char* payload, uint32_t size);
+
+    // Messages lost to a full queue since startup
+    uint64_t DroppedCount() const {
+      return dropped_.load(std::memory_order_relaxed);
     }
 
     template <typename... Args>
     void Log(LogLevel level, std::string_view funcName, fmt::format_string<Args...> fmt, Args&&... args) {
-      std::unique_lock<std::mutex> lock(logMutex_);
-
       // immediately terminate if fatal
-      if (level == LogLevel::Fatal) {
-        std::string msg = fmt::format(fmt, std::forward<Args>(args)...);
-        (*output_) << "\033[31m[FATAL] " << msg << "\033[0m (from: " << TrimArgsFromFunctionName(FUNC_NAME) << ")" << std::endl; 
+      if (level == LogLevel::Fatal)
+        Fatal(funcName, fmt::format(fmt, std::forward<Args>(args)...));
+
+      uint64_t pos;
+      Slot* slot = AcquireSlot(pos);
+      if (slot == nullptr)
+        return;
 
-        isRunning_ = false;
-        std::terminate();
+      // Format straight into the slot, no allocation on the calling thread
+      auto result = fmt::format_to_n(slot->message, V8_LOG_MESSAGE_CAPACITY, fmt, std::forward<Args>(args)...);
+      slot->truncated = result.size > V8_LOG_MESSAGE_CAPACITY;
+      slot->length = static_cast<uint32_t>(slot->truncated ? V8_LOG_MESSAGE_CAPACITY : result.size);
+      slot->level = level;
+      slot->site = 0;
+      slot->funcName = funcName;
+
+      PublishSlot(slot, pos);
+    }
+
+    // Copies the arguments' raw bytes into the queue; formatting happens on the logger thread
+    template <typename... Args>
+    void LogDeferred(uint32_t site, LogLevel level, std::string_view funcName, fmt::format_string<Args...> fmt, Args&&... args) {
+      if constexpr ((V8_LogCapturable<std::decay_t<Args>> && ...)) {
+        if (site != 0 && level != LogLevel::Fatal) {
+          uint64_t pos;
+          Slot* slot = AcquireSlot(pos);
+          if (slot == nullptr)
+            return;
+
+          V8_LogArgWriter writer { slot->message, V8_LOG_MESSAGE_CAPACITY };
+          (writer.Write(args), ...);
+
+          slot->truncated = writer.truncated;
+          slot->length = writer.size;
+          slot->level = level;
+          slot->site = site;
+          slot->funcName = funcName;
+
+          PublishSlot(slot, pos);
+          return;
+        }
       }
 
-      logQueue_.push(std::make_tuple(fmt::format(fmt, std::forward<Args>(args)...), std::string(TrimArgsFromFunctionName(funcName)), level));
-      logCondition_.notify_one();
+      Log(level, funcName, fmt, std::forward<Args>(args)...);
     }
 };
 
 extern V8_Logger logger;
 
-#ifdef NDEBUG
-  #define V_DEBUG(fmt_str, ...) (void)0
-  #define V_INFO(fmt_str, ...) (void)0
+// Deferred call sites register their format string once, then only enqueue argument bytes
+#ifdef V8_LOG_DEFERRED
+  #define V8_LOG_EMIT(level, funcName, fmt_str, ...) \
+    static const uint32_t v8LogSite = logger.RegisterSite(level, fmt_str, funcName); \
+    logger.LogDeferred(v8LogSite, level, funcName, fmt_str, ##__VA_ARGS__)
 #else
-  #define V_DEBUG(fmt_str, ...) \
-    logger.Log(V8_Logger::LogLevel::Debug, TrimArgsFromFunctionName(FUNC_NAME), fmt_str, ##__VA_ARGS__)
-
-  #define V_INFO(fmt_str, ...) \
-    logger.Log(V8_Logger::LogLevel::Info, TrimArgsFromFunctionName(FUNC_NAME), fmt_str, ##__VA_ARGS__)
+  #define V8_LOG_EMIT(level, funcName, fmt_str, ...) \
+    logger.Log(level, funcName, fmt_str, ##__VA_ARGS__)
 #endif
 
-#define V_WARNING(fmt_str, ...) \
-  logger.Log(V8_Logger::LogLevel::Warning, TrimArgsFromFunctionName(FUNC_NAME), fmt_str, ##__VA_ARGS__)
+// Levels under V8_LOG_MIN_LEVEL are discarded at compile time. The runtime
+// filter runs before the arguments are evaluated, so a disabled call is one branch.
+#define V8_LOG_AT(level, fmt_str, ...) \
+  do { \
+    if constexpr (static_cast<int>(level) >= V8_LOG_MIN_LEVEL) { \
+      if (logger.ShouldLog(level, V8_LOG_CATEGORY)) { \
+        static constexpr std::string_view v8LogFunc = TrimArgsFromFunctionName(FUNC_NAME); \
+        V8_LOG_EMIT(level, v8LogFunc, fmt_str, ##__VA_ARGS__); \
+      } \
+    } \
+  } while (0)
+
+// Like V8_LOG_AT, but at most perSecond messages from this call site after an
+// initial burst. The number dropped is reported with the next message that gets through.
+#define V8_LOG_LIMITED_AT(level, perSecond, burst, fmt_str, ...) \
+  do { \
+    if constexpr (static_cast<int>(level) >= V8_LOG_MIN_LEVEL) { \
+      if (logger.ShouldLog(level, V8_LOG_CATEGORY)) { \
+        static V8_LogRateLimiter v8LogLimiter(perSecond, burst); \
+        uint64_t v8LogSuppressed; \
+        if (v8LogLimiter.Acquire(v8LogSuppressed)) { \
+          static constexpr std::string_view v8LogFunc = TrimArgsFromFunctionName(FUNC_NAME); \
+          if (v8LogSuppressed > 0) \
+            logger.Log(level, v8LogFunc, "{} messages suppressed by rate limit", v8LogSuppressed); \
+          V8_LOG_EMIT(level, v8LogFunc, fmt_str, ##__VA_ARGS__); \
+        } \
+      } \
+    } \
+  } while (0)
+
+#define V_DEBUG(fmt_str, ...) V8_LOG_AT(V8_Logger::LogLevel::Debug, fmt_str, ##__VA_ARGS__)
+#define V_INFO(fmt_str, ...) V8_LOG_AT(V8_Logger::LogLevel::Info, fmt_str, ##__VA_ARGS__)
+#define V_WARNING(fmt_str, ...) V8_LOG_AT(V8_Logger::LogLevel::Warning, fmt_str, ##__VA_ARGS__)
+#define V_ERROR(fmt_str, ...) V8_LOG_AT(V8_Logger::LogLevel::Error, fmt_str, ##__VA_ARGS__)
+
+// For call sites that can fire every frame or from validation layers
+#define V_DEBUG_LIMITED(fmt_str, ...) V8_LOG_LIMITED_AT(V8_Logger::LogLevel::Debug, V8_LOG_RATE_LIMIT, V8_LOG_RATE_BURST, fmt_str, ##__VA_ARGS__)
+#define V_INFO_LIMITED(fmt_str, ...) V8_LOG_LIMITED_AT(V8_Logger::LogLevel::Info, V8_LOG_RATE_LIMIT, V8_LOG_RATE_BURST, fmt_str, ##__VA_ARGS__)
+#define V_WARNING_LIMITED(fmt_str, ...) V8_LOG_LIMITED_AT(V8_Logger::LogLevel::Warning, V8_LOG_RATE_LIMIT, V8_LOG_RATE_BURST, fmt_str, ##__VA_ARGS__)
+#define V_ERROR_LIMITED(fmt_str, ...) V8_LOG_LIMITED_AT(V8_Logger::LogLevel::Error, V8_LOG_RATE_LIMIT, V8_LOG_RATE_BURST, fmt_str, ##__VA_ARGS__)
 
-#define V_ERROR(fmt_str, ...) \
-  logger.Log(V8_Logger::LogLevel::Error, TrimArgsFromFunctionName(FUNC_NAME), fmt_str, ##__VA_ARGS__)
+// Info level, but kept in builds that compile info out. For reports the application asked for.
+#define V_REPORT(fmt_str, ...) \
+  do { \
+    if (logger.ShouldLog(V8_Logger::LogLevel::Info, V8_LOG_CATEGORY)) { \
+      static constexpr std::string_view v8LogFunc = TrimArgsFromFunctionName(FUNC_NAME); \
+      V8_LOG_EMIT(V8_Logger::LogLevel::Info, v8LogFunc, fmt_str, ##__VA_ARGS__); \
+    } \
+  } while (0)
 
 #define V_FATAL(fmt_str, ...) \
-  logger.Log(V8_Logger::LogLevel::Fatal, TrimArgsFromFunctionName(FUNC_NAME), fmt_str, ##__VA_ARGS__)
+  do { \
+    static constexpr std::string_view v8LogFunc = TrimArgsFromFunctionName(FUNC_NAME); \
+    logger.Log(V8_Logger::LogLevel::Fatal, v8LogFunc, fmt_str, ##__VA_ARGS__); \
+  } while (0)
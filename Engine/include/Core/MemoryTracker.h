@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <array>
+
+struct VkAllocationCallbacks;
+
+enum class V8_MemoryTag : uint8_t {
+  General,
+  ECS,
+  Renderer,
+  Logger,
+  Assets,
+  Driver, // Vulkan and VMA host allocations
+  Count
+};
+
+struct V8_MemoryStats {
+  uint64_t liveBytes;
+  uint64_t peakBytes;
+  uint64_t allocations; // total since startup
+  uint64_t liveAllocations;
+};
+
+// Per-subsystem allocation counters. Builds with V8_MEMORY_TRACKING replace the global
+// operator new and delete to feed them, tagging each allocation with the calling thread's
+// current V8_MemoryScope, and hand Vulkan the callbacks from V8_VulkanAllocator.
+// Frees are charged to the tag the allocation was made under. Pooled objects count one
+// by one, the slabs behind them are not counted.
+class V8_MemoryTracker {
+  private:
+    struct Counters {
+      std::atomic<uint64_t> liveBytes { 0 };
+      std::atomic<uint64_t> peakBytes { 0 };
+      std::atomic<uint64_t> allocations { 0 };
+      std::atomic<uint64_t> liveAllocations { 0 };
+    };
+
+    std::array<Counters, static_cast<size_t>(V8_MemoryTag::Count)> counters_;
+
+  public:
+    static constexpr bool Enabled() {
+#ifdef V8_MEMORY_TRACKING
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    static const char* TagName(V8_MemoryTag tag);
+
+    void OnAllocate(V8_MemoryTag tag, size_t size);
+    void OnFree(V8_MemoryTag tag, size_t size);
+
+    V8_MemoryStats GetStats(V8_MemoryTag tag) const;
+
+    // Live, peak and count for every tag
+    void Report() const;
+
+    // Prints every tag that still holds allocations to stderr. Tracking builds run it on their
+    // own after static destruction, once globals such as the logger have released their memory.
+    void ReportLeaks() const;
+};
+
+extern V8_MemoryTracker memoryTracker;
+
+// Tags allocations made by the calling thread until it goes out of scope
+class V8_MemoryScope {
+  private:
+    V8_MemoryTag previous_;
+
+  public:
+    V8_MemoryScope(V8_MemoryTag tag);
+    ~V8_MemoryScope();
+
+    V8_MemoryScope(const V8_MemoryScope&) = delete;
+    V8_MemoryScope& operator=(const V8_MemoryScope&) = delete;
+
+    static V8_MemoryTag Current();
+};
+
+// Pass to vkCreate* and the matching vkDestroy*, nullptr unless tracking is compiled in
+const VkAllocationCallbacks* V8_VulkanAllocator();
+
+#define V8_MEMORY_CONCAT_INNER(a, b) a##b
+#define V8_MEMORY_CONCAT(a, b) V8_MEMORY_CONCAT_INNER(a, b)
+
+#ifdef V8_MEMORY_TRACKING
+  #define V_MEMORY_SCOPE(tag) V8_MemoryScope V8_MEMORY_CONCAT(v8MemoryScope, __LINE__)(tag)
+#else
+  #define V_MEMORY_SCOPE(tag) (void)0
+#endif
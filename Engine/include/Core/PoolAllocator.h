@@ -0,0 +1,236 @@
+#pragma once
+
+#include <Core/MemoryTracker.h>
+
+#include <unordered_map>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <memory>
+#include <mutex>
+
+// Shared free list of fixed-size nodes carved out of slabs. Slabs are never returned,
+// a freed node goes back on the list and is handed out again in O(1).
+class V8_PoolStorage {
+  public:
+    struct Node {
+      Node* next;
+    };
+
+  private:
+    struct Slab {
+      Slab* next;
+    };
+
+    size_t nodeSize_;
+    size_t alignment_;
+    size_t nodesPerSlab_;
+
+    Slab* slabs_ = nullptr;
+    Node* free_ = nullptr;
+    std::mutex mutex_;
+
+    void AddSlab();
+
+  public:
+    V8_PoolStorage(size_t size, size_t alignment, size_t nodesPerSlab);
+    ~V8_PoolStorage();
+
+    V8_PoolStorage(const V8_PoolStorage&) = delete;
+    V8_PoolStorage& operator=(const V8_PoolStorage&) = delete;
+
+    // Unlinks up to count nodes and returns them as a list, count is set to how many it took
+    Node* AllocateBatch(uint32_t& count);
+
+    // Links a list of nodes from head to tail back into the free list
+    void FreeBatch(Node* head, Node* tail);
+};
+
+// One pool per size class, shared by every type that fits it. With ThreadCache each
+// thread keeps a short free list of its own and only takes the lock to move nodes
+// between it and the shared list in batches.
+template <size_t Size, size_t Alignment, bool ThreadCache = true>
+class V8_Pool {
+  private:
+    using Node = V8_PoolStorage::Node;
+
+#ifdef V8_MEMORY_TRACKING
+    // Room in front of each object for the tag it was allocated under, so its free is charged back to it
+    static constexpr size_t headerSize = Alignment;
+#else
+    static constexpr size_t headerSize = 0;
+#endif
+
+    static constexpr size_t nodeSize = std::max(Size + headerSize, sizeof(Node));
+    static constexpr size_t nodeAlignment = std::max(Alignment, alignof(Node));
+    static constexpr size_t nodesPerSlab = std::max<size_t>(64 * 1024 / nodeSize, 32);
+    static constexpr uint32_t batchSize = 32;
+
+    // Trivially destructible so it stays usable after the thread has handed its nodes back,
+    // frees during static destruction then go straight to the shared list
+    struct Cache {
+      Node* head = nullptr;
+      uint32_t count = 0;
+      bool released = false;
+    };
+
+    struct CacheRelease {
+      ~CacheRelease() {
+        Cache& cache = LocalCache();
+        cache.released = true;
+
+        if (cache.head == nullptr)
+          return;
+
+        Node* tail = cache.head;
+        while (tail->next != nullptr)
+          tail = tail->next;
+        Storage().FreeBatch(cache.head, tail);
+
+        cache.head = nullptr;
+        cache.count = 0;
+      }
+    };
+
+    // Never destroyed so objects released during static destruction can still free into it
+    static V8_PoolStorage& Storage() {
+      alignas(V8_PoolStorage) static std::byte buffer[sizeof(V8_PoolStorage)];
+      static V8_PoolStorage* storage = new (buffer) V8_PoolStorage(nodeSize, nodeAlignment, nodesPerSlab);
+      return *storage;
+    }
+
+    static Cache& LocalCache() {
+      thread_local Cache cache;
+      thread_local CacheRelease release;
+      return cache;
+    }
+
+    static Node* AllocateNode() {
+      if constexpr (!ThreadCache) {
+        uint32_t count = 1;
+        return Storage().AllocateBatch(count);
+      } else {
+        Cache& cache = LocalCache();
+        if (cache.released) {
+          uint32_t count = 1;
+          return Storage().AllocateBatch(count);
+        }
+
+        if (cache.head == nullptr) {
+          cache.count = batchSize;
+          cache.head = Storage().AllocateBatch(cache.count);
+        }
+
+        Node* node = cache.head;
+        cache.head = node->next;
+        cache.count--;
+        return node;
+      }
+    }
+
+    static void FreeNode(Node* node) {
+      if constexpr (!ThreadCache) {
+        node->next = nullptr;
+        Storage().FreeBatch(node, node);
+      } else {
+        Cache& cache = LocalCache();
+        if (cache.released) {
+          node->next = nullptr;
+          Storage().FreeBatch(node, node);
+          return;
+        }
+
+        node->next = cache.head;
+        cache.head = node;
+        cache.count++;
+
+        // Keeps one batch for this thread and hands the rest back, a thread that only
+        // frees objects made elsewhere can't hoard them
+        if (cache.count < batchSize * 2)
+          return;
+
+        Node* tail = cache.head;
+        for (uint32_t i = 1; i < batchSize; i++)
+          tail = tail->next;
+
+        Node* rest = tail->next;
+        tail->next = nullptr;
+        Storage().FreeBatch(cache.head, tail);
+        cache.head = rest;
+        cache.count -= batchSize;
+      }
+    }
+
+  public:
+    static void* Allocate() {
+      std::byte* node = reinterpret_cast<std::byte*>(AllocateNode());
+
+#ifdef V8_MEMORY_TRACKING
+      V8_MemoryTag tag = V8_MemoryScope::Current();
+      std::memcpy(node, &tag, sizeof(tag));
+      memoryTracker.OnAllocate(tag, Size);
+#endif
+
+      return node + headerSize;
+    }
+
+    static void Free(void* pointer) {
+      std::byte* node = static_cast<std::byte*>(pointer) - headerSize;
+
+#ifdef V8_MEMORY_TRACKING
+      V8_MemoryTag tag;
+      std::memcpy(&tag, node, sizeof(tag));
+      memoryTracker.OnFree(tag, Size);
+#endif
+
+      FreeNode(reinterpret_cast<Node*>(node));
+    }
+};
+
+// STL allocator that takes single objects from the pool for their size class. Arrays,
+// such as vector storage or hash buckets, go to the heap as usual.
+template <typename T, bool ThreadCache = true>
+struct V8_PoolStlAllocator {
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = V8_PoolStlAllocator<U, ThreadCache>;
+  };
+
+  V8_PoolStlAllocator() = default;
+
+  template <typename U>
+  V8_PoolStlAllocator(const V8_PoolStlAllocator<U, ThreadCache>&) {}
+
+  T* allocate(size_t count) {
+    if (count == 1)
+      return static_cast<T*>(V8_Pool<sizeof(T), alignof(T), ThreadCache>::Allocate());
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* pointer, size_t count) {
+    if (count == 1)
+      V8_Pool<sizeof(T), alignof(T), ThreadCache>::Free(pointer);
+    else
+      std::allocator<T>().deallocate(pointer, count);
+  }
+
+  template <typename U>
+  bool operator==(const V8_PoolStlAllocator<U, ThreadCache>&) const {
+    return true;
+  }
+};
+
+// make_shared with the object and its control block in one pool node
+template <typename T, typename... Args>
+std::shared_ptr<T> V8_MakePooled(Args&&... args) {
+  return std::allocate_shared<T>(V8_PoolStlAllocator<T>(), std::forward<Args>(args)...);
+}
+
+template <typename K, typename V>
+using V8_PooledMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, V8_PoolStlAllocator<std::pair<const K, V>>>;
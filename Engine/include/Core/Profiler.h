@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Core/Logger.h>
+
+#include <string_view>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#ifndef V8_PROFILE_EVENTS_PER_THREAD
+  #define V8_PROFILE_EVENTS_PER_THREAD 65536 // zones past this are dropped until Clear
+#endif
+
+struct V8_ProfileEvent {
+  std::string_view name; // zones are named with static strings
+  uint64_t start;
+  uint64_t end;
+};
+
+// Collects timed zones into per-thread buffers. Only the owning thread writes
+// its buffer and publishes each event with a release store, so recording a
+// zone never takes a lock. Export reads whatever has been published so far.
+class V8_Profiler {
+  private:
+    struct ThreadBuffer {
+      uint32_t id;
+      std::string name;
+      bool retired = false; // its thread exited or its track was released, the next one takes it over
+      std::atomic<uint32_t> generation { 0 };
+      std::atomic<uint32_t> count { 0 };
+      std::unique_ptr<V8_ProfileEvent[]> events; // allocated by the first zone, so only while enabled
+    };
+
+    // The calling thread's name, and its buffer once it has recorded a zone
+    struct LocalState {
+      ThreadBuffer* buffer = nullptr;
+      std::string name;
+
+      ~LocalState();
+    };
+
+    std::atomic<bool> enabled_ { false };
+    std::atomic<uint32_t> generation_ { 0 };
+    std::atomic<uint64_t> dropped_ { 0 };
+    uint64_t origin_;
+
+    // Buffers are never freed, a retired one is handed to the next thread or track with its events
+    std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+    std::mutex mutex_;
+
+    static LocalState& Local();
+    ThreadBuffer* LocalBuffer();
+    ThreadBuffer* CreateBuffer(std::string_view name);
+    void Append(ThreadBuffer* buffer, std::string_view name, uint64_t start, uint64_t end);
+
+  public:
+    V8_Profiler();
+
+    static uint64_t Now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void SetEnabled(bool enabled) {
+      enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool IsEnabled() const {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // Track name for the calling thread in trace viewers. Only stored until the thread records a zone.
+    void SetThreadName(std::string_view name);
+
+    void Record(std::string_view name, uint64_t start, uint64_t end);
+
+    // Tracks hold timings that don't belong to a CPU thread, such as GPU passes.
+    // Times are in Now()'s domain, and a track must only be recorded from one thread at a time.
+    uint32_t CreateTrack(std::string_view name);
+    void RecordOnTrack(uint32_t track, std::string_view name, uint64_t start, uint64_t end);
+
+    // Lets a later thread or track reuse the track's buffer, what it recorded stays in the trace
+    void ReleaseTrack(uint32_t track);
+
+    // Discards everything recorded so far. Each thread resets its buffer on its next zone.
+    void Clear();
+
+    // Zones lost to full buffers since the last Clear
+    uint64_t DroppedCount() const {
+      return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Chrome trace event JSON, opens in chrome://tracing and ui.perfetto.dev
+    bool WriteChromeTrace(const std::string& path);
+};
+
+extern V8_Profiler profiler;
+
+// Records the time between construction and destruction while the profiler is enabled
+class V8_ProfileZone {
+  private:
+    std::string_view name_;
+    uint64_t start_;
+
+  public:
+    V8_ProfileZone(std::string_view name) : name_(name), start_(profiler.IsEnabled() ? V8_Profiler::Now() : 0) {}
+
+    ~V8_ProfileZone() {
+      if (start_ != 0)
+        profiler.Record(name_, start_, V8_Profiler::Now());
+    }
+
+    V8_ProfileZone(const V8_ProfileZone&) = delete;
+    V8_ProfileZone& operator=(const V8_ProfileZone&) = delete;
+};
+
+#define V8_PROFILE_CONCAT_INNER(a, b) a##b
+#define V8_PROFILE_CONCAT(a, b) V8_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef V8_PROFILE
+  #define V_PROFILE_SCOPE(name) V8_ProfileZone V8_PROFILE_CONCAT(v8ProfileZone, __LINE__)(name)
+  #define V_PROFILE_FUNCTION() \
+    static constexpr std::string_view V8_PROFILE_CONCAT(v8ProfileFunc, __LINE__) = TrimArgsFromFunctionName(FUNC_NAME); \
+    V8_ProfileZone V8_PROFILE_CONCAT(v8ProfileZone, __LINE__)(V8_PROFILE_CONCAT(v8ProfileFunc, __LINE__))
+#else
+  #define V_PROFILE_SCOPE(name) (void)0
+  #define V_PROFILE_FUNCTION() (void)0
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include <cstdint>
+#include <vector>
+#include <deque>
+
+// Persistently mapped ring of host-visible memory for buffer uploads. Copies
+// are batched into one command buffer per Submit(); space is reclaimed once a
+// batch's fence signals, so uploads never wait on the queue unless the ring is
+// full. Each batch ends with a barrier that makes its writes visible to any
+// later submission on the same queue.
+class V8_StagingRing {
+  private:
+    struct Batch {
+      VkCommandBuffer cmd = VK_NULL_HANDLE;
+      VkFence fence = VK_NULL_HANDLE;
+      VkDeviceSize bytes = 0;
+    };
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    VkQueue queue_ = VK_NULL_HANDLE;
+    VkCommandPool commandPool_ = VK_NULL_HANDLE;
+
+    VkBuffer buffer_ = VK_NULL_HANDLE;
+    VmaAllocation allocation_ = VK_NULL_HANDLE;
+    uint8_t* mapped_ = nullptr;
+
+    VkDeviceSize capacity_ = 0;
+    VkDeviceSize head_ = 0;
+    VkDeviceSize used_ = 0;
+
+    Batch current_;
+    bool recording_ = false;
+
+    std::deque<Batch> inFlight_;
+    std::vector<Batch> freeBatches_;
+
+    void BeginBatch();
+    void Reclaim(bool waitOldest);
+
+  public:
+    uint64_t bytesUploaded_ = 0;
+    uint64_t submissions_ = 0;
+    uint64_t stallNanoseconds_ = 0; // blocked on batch fences in Allocate and Flush
+
+    void Init(VkDevice device, VmaAllocator allocator, VkQueue queue, VkCommandPool commandPool, VkDeviceSize capacity);
+    void Shutdown();
+
+    VkDeviceSize Capacity() const {
+      return capacity_;
+    }
+
+    // Reserves size bytes of staging memory, waiting for older batches if the ring is full.
+    // The returned pointer is valid until the batch it is copied in completes.
+    uint8_t* Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+    // Records a copy from a previously allocated staging range into dst
+    void Copy(VkBuffer dst, VkDeviceSize dstOffset, VkDeviceSize srcOffset, VkDeviceSize size);
+
+    // Copies src into staging and records the transfer, splitting uploads larger than the ring
+    void Upload(VkBuffer dst, VkDeviceSize dstOffset, const void* src, VkDeviceSize size);
+
+    // Submits all recorded copies without waiting
+    void Submit();
+
+    // Submits and blocks until every batch has completed
+    void Flush();
+};
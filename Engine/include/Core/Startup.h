@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <vector>
+#include <mutex>
+
+struct V8_StartupPhase {
+  std::string_view name; // phases are named with static strings
+  uint64_t start;
+  uint64_t end;
+};
+
+// Collects named phases from engine startup, including ones run on worker
+// threads, and logs them as one breakdown. Phases also go to the profiler
+// while it is enabled.
+class V8_StartupTimeline {
+  private:
+    std::vector<V8_StartupPhase> phases_;
+    std::mutex mutex_;
+    uint64_t origin_ = 0;
+    uint64_t last_ = 0;
+
+  public:
+    // Starts a new timeline, Mark and Record do nothing before this or after Report
+    void Begin();
+
+    // Ends a phase that started at the previous Mark or at Begin. Call from one thread only.
+    void Mark(std::string_view name);
+
+    // Adds a phase timed elsewhere, typically on a worker thread. Times are in V8_Profiler::Now()'s domain.
+    void Record(std::string_view name, uint64_t start, uint64_t end);
+
+    // Logs each phase with its offset from Begin, then stops recording
+    void Report();
+};
+
+extern V8_StartupTimeline startupTimeline;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+class V8_ThreadPool {
+  private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskCondition_;
+    std::condition_variable idleCondition_;
+    size_t activeTasks_ = 0;
+    bool stopping_ = false;
+
+    void WorkerLoop(std::string name);
+
+  public:
+    // threadCount of 0 uses one worker per hardware thread, name is the workers' profiler track
+    explicit V8_ThreadPool(uint32_t threadCount = 0, std::string name = "Worker");
+    ~V8_ThreadPool();
+
+    V8_ThreadPool(const V8_ThreadPool&) = delete;
+    V8_ThreadPool& operator=(const V8_ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task);
+
+    // Blocks until the queue is empty and no task is running
+    void WaitIdle();
+
+    uint32_t Size() const {
+      return static_cast<uint32_t>(workers_.size());
+    }
+};
@@ -8,7 +8,7 @@
 
 class V8_Window {
   private:
-    SDL_Window* window_;
+    SDL_Window* window_ = nullptr;
 
   public:
     void Init(uint32_t width, uint32_t height, const char* title, bool resizable = false, bool fullscreen = false) {
@@ -107,6 +107,19 @@ struct V8_RenderConfig {
   uint32_t engineVersion;
 
   uint32_t apiVersion;
+
+  // Max screen-space error in pixels allowed when picking a mesh LOD
+  float lodErrorThreshold;
+
+  // SPIR-V of shaders/cull.comp, by default the one the build compiled; meshlet culling is disabled when null.
+  // It only runs for scenes with a camera.
+  const char* meshletCullShaderPath;
+
+  // Timestamp queries around each pass, see V8_Renderer::GetGpuTimer
+  bool gpuTimers;
+
+  // Pipeline statistics query over each frame, see V8_Renderer::GetStats
+  bool pipelineStatistics;
 };
 
 extern V8_RenderConfig defaultRenderConfig;
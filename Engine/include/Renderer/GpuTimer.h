@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Core/Context.h>
+
+#include <vulkan/vulkan.h>
+#include <string_view>
+#include <vector>
+
+#define V8_INVALID_GPU_ZONE 0xFFFFFFFFu
+
+struct V8_GpuZone {
+  std::string_view name; // zones are named with static strings
+  double milliseconds;
+};
+
+// Brackets GPU work with timestamp queries. Each frame in flight owns a range
+// of the query pool; a range is read back when its frame slot comes around
+// again, after the renderer has waited on that slot's fence, so results are
+// framesInFlight frames old and never stall.
+class V8_GpuTimer {
+  private:
+    struct FrameQueries {
+      std::vector<std::string_view> names;
+      uint32_t written = 0;
+      bool submitted = false;
+      uint64_t cpuSubmit = 0;
+    };
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkQueryPool pool_ = VK_NULL_HANDLE;
+    uint32_t zonesPerFrame_ = 0;
+    double period_ = 0.0;
+    uint64_t validMask_ = 0;
+
+    std::vector<FrameQueries> frames_;
+    std::vector<uint64_t> timestamps_;
+    uint32_t frame_ = 0;
+    uint32_t profilerTrack_ = 0;
+
+    std::vector<V8_GpuZone> results_;
+    double frameMilliseconds_ = 0.0;
+
+    void Resolve(FrameQueries& frame);
+
+  public:
+    V8_GpuTimer() = default;
+    V8_GpuTimer(const V8_GpuTimer&) = delete;
+    V8_GpuTimer& operator=(const V8_GpuTimer&) = delete;
+    ~V8_GpuTimer();
+
+    // Does nothing if the graphics queue can't write timestamps
+    void Init(V8_Context& context, uint32_t framesInFlight, uint32_t zonesPerFrame = 16);
+    void Shutdown();
+
+    bool IsSupported() const {
+      return pool_ != VK_NULL_HANDLE;
+    }
+
+    // Call right after beginning the frame's command buffer, once its fence has been waited on
+    void BeginFrame(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    // Call before submitting the frame's command buffer
+    void EndFrame();
+
+    // Must not straddle a render pass boundary
+    uint32_t BeginZone(VkCommandBuffer cmd, std::string_view name);
+    void EndZone(VkCommandBuffer cmd, uint32_t zone);
+
+    // Zones of the most recently resolved frame
+    const std::vector<V8_GpuZone>& GetResults() const {
+      return results_;
+    }
+
+    // First zone start to last zone end of that frame
+    double GetFrameMilliseconds() const {
+      return frameMilliseconds_;
+    }
+};
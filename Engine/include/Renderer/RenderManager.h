@@ -1,15 +1,18 @@
 #pragma once
 
 #include <Renderer/Renderer.h>
+#include <Core/PoolAllocator.h>
 
 #include <unordered_map>
 
 class V8_RenderManager {
   private:
     V8_Context* context_;
-    std::unordered_map<std::string, V8_Renderer> renderers_;
+    V8_PooledMap<std::string, V8_Renderer> renderers_;
     uint32_t nextId_ = 0;
 
+    V8_ShaderLoader shaderLoader_;
+
   public:
     void Init(V8_Context* context) {
       context_ = context;
@@ -19,11 +22,27 @@ class V8_RenderManager {
       renderers_.clear();
     }
 
+    // Starts reading a shader file in the background, safe to call before Init.
+    // CreateRenderer picks the bytes up instead of reading the file again.
+    void PreloadShader(const std::string& path) {
+      shaderLoader_.Preload(path);
+    }
+
     void CreateRenderer(const std::string& name, const char* vertexShaderPath, const char* fragmentShaderPath, const V8_RenderPassDescription& renderPassDesc, const V8_RenderConfig& config = defaultRenderConfig);
     void RemoveRenderer(const std::string& name);
     V8_Renderer* GetRenderer(const std::string& name);
     void Render(const std::string& name);
     void RenderAll();
+
+    // RenderAll split at the frame sync point, see V8_Renderer::Extract
+    void ExtractAll();
+    void RenderAllExtracted();
+
+    // Blocks until every renderer could start its next frame, see V8_Renderer::WaitForFrame
+    void WaitForFrames();
+
+    void StoreTransforms();
+    void SetInterpolation(float alpha);
     void BindScene(const std::string& name, V8_Scene* scene) {
       if (renderers_.find(name) != renderers_.end())
         renderers_[name].BindScene(*scene);
@@ -35,4 +54,14 @@ class V8_RenderManager {
     }
 
     void HandleResize();
+
+    // Counters of each renderer's last submitted frame, null for unknown names
+    const V8_RenderStats* GetStats(const std::string& name) const;
+    V8_RenderStats GetTotalStats() const;
+
+    // Logs the counters of every renderer
+    void DumpStats() const;
+
+    // Sums the renderers' phase timings of the last RenderAll
+    void AddFrameTimings(V8_FrameSample& sample) const;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Core/Context.h>
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+struct V8_RenderStats {
+  // Counted while recording the frame
+  uint32_t drawCalls = 0;      // each indirect draw counts once
+  uint64_t instances = 0;
+  uint64_t triangles = 0;      // submitted, meshlet draws count before GPU culling
+  uint32_t pipelineBinds = 0;
+  uint32_t descriptorBinds = 0;
+  uint32_t bufferBinds = 0;    // vertex and index buffers
+  uint32_t dispatches = 0;
+
+  // VK_QUERY_TYPE_PIPELINE_STATISTICS, frames in flight behind the counters above
+  bool hasPipelineStatistics = false;
+  uint64_t inputAssemblyVertices = 0;
+  uint64_t inputAssemblyPrimitives = 0;
+  uint64_t vertexShaderInvocations = 0;
+  uint64_t clippingInvocations = 0;
+  uint64_t clippingPrimitives = 0;
+  uint64_t fragmentShaderInvocations = 0;
+  uint64_t computeShaderInvocations = 0;
+
+  V8_RenderStats& operator+=(const V8_RenderStats& other);
+};
+
+// One pipeline statistics query per frame in flight, read back the same way
+// as V8_GpuTimer: when the frame slot comes around again, after its fence.
+class V8_PipelineStatistics {
+  private:
+    struct FrameQuery {
+      bool active = false;
+      bool submitted = false;
+    };
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkQueryPool pool_ = VK_NULL_HANDLE;
+    std::vector<FrameQuery> frames_;
+    uint32_t frame_ = 0;
+
+    bool resolved_ = false;
+    uint64_t results_[7] = {};
+
+  public:
+    V8_PipelineStatistics() = default;
+    V8_PipelineStatistics(const V8_PipelineStatistics&) = delete;
+    V8_PipelineStatistics& operator=(const V8_PipelineStatistics&) = delete;
+    ~V8_PipelineStatistics();
+
+    // Does nothing unless the device has pipelineStatisticsQuery enabled
+    void Init(V8_Context& context, uint32_t framesInFlight);
+    void Shutdown();
+
+    // Both outside a render pass; the query covers everything recorded in between
+    void Begin(VkCommandBuffer cmd, uint32_t frameIndex);
+    void End(VkCommandBuffer cmd);
+
+    // Call before submitting the frame's command buffer
+    void EndFrame();
+
+    // Copies the most recently resolved statistics into stats
+    void Fill(V8_RenderStats& stats) const;
+};
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <Renderer/ShaderLoader.h>
+#include <Renderer/RenderStats.h>
+#include <Renderer/GpuTimer.h>
 #include <Renderer/Config.h>
+#include <Scene/AssetManager.h>
+#include <Core/FrameAllocator.h>
+#include <Core/FrameStats.h>
 #include <Core/Context.h>
 #include <Scene/Scene.h>
 
 #include <optional>
+#include <vector>
+#include <memory>
 
 struct V8_RenderPassDescription {
   std::vector<VkAttachmentDescription> attachments_;
@@ -48,9 +56,72 @@ struct V8_RenderPassDescription {
 
 class V8_Renderer {
   private:
+    struct MeshDraw {
+      V8_StaticMesh* mesh;
+      Matrix4 model;
+      uint32_t lod;
+      bool meshletCulled;
+      uint32_t firstCommand; // first of its meshlets' commands in the frame's cull output
+    };
+
     uint32_t currentFrame_ = 0;
+    struct PendingPresent {
+      uint64_t id;
+      uint64_t acquireStart;
+    };
+
+    uint64_t presentId_ = 0;
+    std::vector<PendingPresent> pendingPresents_; // presented but not yet seen on screen, oldest first
+    double presentLatency_ = 0.0;
+    uint32_t lastImageIndex_ = UINT32_MAX;
+    VkImageLayout outputLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
     V8_Context* context_ = nullptr;
     V8_Scene* scene_ = nullptr;
+    V8_RenderConfig config_ = defaultRenderConfig;
+
+    // The snapshot Extract takes of the scene, recording reads nothing else from it
+    V8_FrameVector<MeshDraw> drawList_;
+
+    // Keep the entities' meshes alive while the snapshot is recorded and, handed to the frame
+    // slot at record time, until that slot's fence. Streamed meshes are retired by the asset manager.
+    std::vector<std::shared_ptr<V8_StaticMesh>> extractedMeshes_;
+    std::vector<std::vector<std::shared_ptr<V8_StaticMesh>>> frameMeshes_;
+    std::optional<V8_Camera> camera_;
+    bool extracted_ = false;
+
+    float interpolation_ = 1.0f;
+
+    V8_GpuTimer gpuTimer_;
+    V8_PipelineStatistics pipelineStatistics_;
+
+    V8_RenderStats stats_;
+    V8_RenderStats lastStats_;
+    V8_FrameSample timings_;
+
+    VkDescriptorSetLayout cullDescriptorSetLayout_ = VK_NULL_HANDLE;
+    VkPipelineLayout cullPipelineLayout_ = VK_NULL_HANDLE;
+    VkPipeline cullPipeline_ = VK_NULL_HANDLE;
+
+    // Owned by a frame slot and reused once its fence has signalled. Culling sets are written
+    // per draw, so nothing outlives the meshes it points at, and every culled draw writes its
+    // own range of the indirect commands, so instances of one mesh keep their own visibility.
+    struct CullFrame {
+      std::vector<VkDescriptorPool> pools;
+      size_t current = 0;
+
+      VkBuffer commandBuffer = VK_NULL_HANDLE;
+      VmaAllocation commandAllocation = VK_NULL_HANDLE;
+      uint32_t commandCapacity = 0;
+    };
+
+    std::vector<CullFrame> cullFrames_;
+    uint32_t cullCommandCount_ = 0; // meshlets of every culled draw in drawList_
+
+    V8_StaticMesh* FindMesh(V8_Entity entity);
+
+    void CreateCullPipeline(const char* shaderPath, V8_ShaderLoader& shaderLoader);
+    VkDescriptorSet AllocateCullDescriptorSet(const V8_StaticMesh& mesh, VkBuffer commandBuffer);
+    void RecordMeshletCulling(VkCommandBuffer cmd);
 
   public:
     VkRenderPass renderPass_ = VK_NULL_HANDLE;
@@ -62,12 +133,61 @@ class V8_Renderer {
 
     std::vector<VkFramebuffer> framebuffers_;
 
-    void Init(V8_Context& ctx, const char* vertexShaderPath, const char* fragmentShaderPath, const std::optional<V8_RenderPassDescription>& renderPassDesc = std::nullopt, const V8_RenderConfig& config = defaultRenderConfig);
+    // Shaders come from shaderLoader when given, so reads started with Preload are picked up
+    void Init(V8_Context& ctx, const char* vertexShaderPath, const char* fragmentShaderPath, const std::optional<V8_RenderPassDescription>& renderPassDesc = std::nullopt, const V8_RenderConfig& config = defaultRenderConfig, V8_ShaderLoader* shaderLoader = nullptr);
     ~V8_Renderer();
 
+    // Extract followed by RenderExtracted
     void Render();
+
+    // Copies what recording needs from the bound scene: meshes, transforms, LODs and the camera.
+    // Runs at the frame sync point, RenderExtracted can then run on another thread while the
+    // scene keeps changing. Entities may be removed meanwhile, the snapshot holds their meshes.
+    void Extract();
+    void RenderExtracted();
+
+    // Takes the latency of the newest pending present that reached the screen and drops it and
+    // older ones. Only the newest is waited on for up to timeout, the rest are polled.
+    void MeasurePresentLatency(uint64_t timeout);
+
+    // Blocks until the next frame can start recording: the last presented frame is on screen when
+    // the device has present wait, and the frame slot about to be reused is free. Calling it before
+    // sampling input keeps the CPU from running ahead of the display. Without it the latency
+    // phase is only polled when the next frame starts, so it can read up to a frame high.
+    void WaitForFrame();
+
+    // Saves each mesh's transform before a fixed update, see V8_StaticMesh::StoreTransform
+    void StoreTransforms();
+
+    // Fraction of a fixed step since the last update, Extract blends transforms by it
+    void SetInterpolation(float alpha) {
+      interpolation_ = alpha;
+    }
+
     void HandleResize();
 
+    const V8_GpuTimer& GetGpuTimer() const {
+      return gpuTimer_;
+    }
+
+    // Counters of the last submitted frame
+    const V8_RenderStats& GetStats() const {
+      return lastStats_;
+    }
+
+    // Copies the image of the last submitted frame, see V8_Context::ReadbackImage
+    bool ReadbackLastFrame(std::vector<uint8_t>& pixels) {
+      if (lastImageIndex_ == UINT32_MAX)
+        return false;
+
+      return context_->ReadbackImage(lastImageIndex_, outputLayout_, pixels);
+    }
+
+    // CPU time of the last Render call in the Record, Submit and Wait phases
+    const V8_FrameSample& GetFrameTimings() const {
+      return timings_;
+    }
+
     void BindScene(V8_Scene& scene) {
       scene_ = &scene;
     }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <unordered_map>
+#include <future>
+#include <string>
+#include <vector>
+#include <mutex>
+
+// Reads shader binaries on background threads so file IO overlaps device
+// creation. Get hands out a preloaded file once, anything not preloaded is
+// read on the calling thread.
+class V8_ShaderLoader {
+  private:
+    std::unordered_map<std::string, std::future<std::vector<char>>> pending_;
+    std::mutex mutex_;
+
+  public:
+    void Preload(const std::string& path);
+
+    // Empty if the file could not be read
+    std::vector<char> Get(const std::string& path);
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <Scene/MeshCache.h>
+#include <Scene/Types.h>
+
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+using V8_AssetID = uint32_t;
+
+#define V8_INVALID_ASSET std::numeric_limits<V8_AssetID>::max()
+
+enum class V8_AssetState : uint8_t {
+  Unloaded,
+  Queued,
+  Resident,
+  Failed
+};
+
+class V8_AssetManager;
+
+struct V8_MeshHandle {
+  V8_AssetManager* manager = nullptr;
+  V8_AssetID id = V8_INVALID_ASSET;
+
+  // Null until the mesh is resident, and again once it has been evicted
+  V8_StaticMesh* Get() const;
+
+  bool IsResident() const {
+    return Get() != nullptr;
+  }
+};
+
+// Component for meshes owned by the asset manager. The renderer skips it while not resident.
+struct V8_StreamedMesh {
+  V8_MeshHandle handle;
+};
+
+// Produces geometry on an I/O thread for meshes that don't come from a mesh cache file
+using V8_MeshLoader = std::function<bool(std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices)>;
+
+struct V8_AssetStats {
+  uint64_t residentBytes = 0;
+  uint32_t residentCount = 0;
+  uint32_t queuedCount = 0;
+  uint64_t loads = 0;
+  uint64_t evictions = 0;
+};
+
+// Streams meshes in on background threads. Requests are loaded nearest-first
+// relative to the bound camera, uploaded under a per-frame byte budget, and
+// the farthest resident meshes are evicted when the memory budget is exceeded.
+class V8_AssetManager {
+  private:
+    struct MeshAsset {
+      std::string path;
+      V8_MeshLoader loader;
+
+      Vector3 position = Vector3(0.0f);
+      Vector3 rotation = Vector3(0.0f);
+      Vector3 scale = Vector3(1.0f);
+      float radius = 0.0f;
+
+      V8_AssetState state = V8_AssetState::Unloaded;
+      bool requested = false;
+      float distance = 0.0f;
+      uint64_t bytes = 0;
+      uint64_t retryFrame = 0;
+
+      std::shared_ptr<V8_StaticMesh> mesh;
+    };
+
+    struct LoadRequest {
+      float distance;
+      V8_AssetID id;
+      std::string path;
+      V8_MeshLoader loader;
+    };
+
+    struct LoadResult {
+      V8_AssetID id;
+      bool ok = false;
+      std::unique_ptr<V8_MeshCacheFile> cache;
+      std::shared_ptr<V8_StaticMesh> mesh;
+    };
+
+    struct RetiredMesh {
+      uint64_t frame;
+      std::shared_ptr<V8_StaticMesh> mesh;
+    };
+
+    V8_Context* context_ = nullptr;
+    const V8_Camera* camera_ = nullptr;
+
+    uint64_t budget_ = 0;
+    uint64_t uploadBytesPerFrame_ = 0;
+    uint64_t frame_ = 0;
+
+    // Main thread only
+    std::vector<MeshAsset> assets_;
+    std::vector<RetiredMesh> retired_;
+    V8_AssetStats stats_;
+
+    // Shared with the I/O threads, guarded by mutex_
+    std::vector<std::thread> ioThreads_;
+    std::vector<LoadRequest> queue_;
+    std::vector<LoadResult> completed_;
+    std::mutex mutex_;
+    std::condition_variable queueCondition_;
+    bool stopping_ = false;
+
+    static bool NearestFirst(const LoadRequest& a, const LoadRequest& b);
+
+    void IOLoop();
+    void UpdatePriorities();
+    void ProcessCompleted();
+    void QueueRequests();
+    bool MakeRoom(uint64_t bytes, float distance);
+    void Evict(V8_AssetID id);
+
+  public:
+    V8_AssetManager() = default;
+    V8_AssetManager(const V8_AssetManager&) = delete;
+    V8_AssetManager& operator=(const V8_AssetManager&) = delete;
+    ~V8_AssetManager();
+
+    void Init(V8_Context& context);
+    void Shutdown();
+
+    void BindCamera(const V8_Camera* camera) {
+      camera_ = camera;
+    }
+
+    // Loads a mesh cache file (see Scene/MeshCache.h) placed at the given transform
+    V8_MeshHandle RequestMesh(const std::string& path, const Vector3& position, const Vector3& rotation = Vector3(0.0f), const Vector3& scale = Vector3(1.0f));
+    V8_MeshHandle RequestMesh(V8_MeshLoader loader, const Vector3& position, const Vector3& rotation = Vector3(0.0f), const Vector3& scale = Vector3(1.0f));
+
+    // Drops the request and frees the mesh once no frame in flight can use it
+    void Release(V8_MeshHandle handle);
+
+    V8_StaticMesh* GetMesh(V8_AssetID id) const;
+    V8_AssetState GetState(V8_AssetID id) const;
+
+    // Call once per frame before rendering
+    void Update();
+
+    const V8_AssetStats& GetStats() const {
+      return stats_;
+    }
+};
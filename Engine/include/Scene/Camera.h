@@ -15,10 +15,19 @@ struct V8_Camera {
   float movementSpeed;
   float mouseSensitivity;
   float zoom;
+  float nearPlane = 0.1f;
+  float farPlane = 1000.0f;
 
   Matrix4 GetViewMatrix() {
     Matrix4 view;
     view = glm::lookAt(position, position + front, up);
     return view;
   }
+
+  // zoom is the vertical field of view in degrees
+  Matrix4 GetProjectionMatrix(float aspectRatio) {
+    Matrix4 projection = glm::perspective(glm::radians(zoom), aspectRatio, nearPlane, farPlane);
+    projection[1][1] *= -1.0f;
+    return projection;
+  }
 };
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Scene/Scene.h>
+
+#include <string>
+
+struct V8_ImportOptions {
+  // 0 uses one worker per hardware thread
+  uint32_t workerCount = 0;
+  bool generateLODs = true;
+};
+
+// Loads a glTF 2.0 (.gltf/.glb) or Wavefront OBJ file into the scene. Buffers
+// are decoded and meshes built on worker threads; each mesh is uploaded
+// through the context's staging ring as soon as it is ready. Every node becomes
+// an entity with a V8_SceneNode component, parented under a root entity that
+// is returned. Returns V8_INVALID_ENTITY on failure.
+V8_Entity V8_ImportScene(V8_Context& context, V8_Scene& scene, const std::string& path, const V8_ImportOptions& options = {});
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Scene/Types.h>
+
+#include <cstdint>
+#include <string>
+
+#define V8_MESH_CACHE_MAGIC 0x434D3856u // "V8MC"
+#define V8_MESH_CACHE_VERSION 1u
+
+// Every section starts on this boundary so it can be copied straight into GPU memory
+#define V8_MESH_CACHE_ALIGNMENT 256u
+
+enum class V8_MeshCacheSection : uint32_t {
+  Vertices,
+  Indices,
+  LODs,
+  Meshlets,
+  Count
+};
+
+struct V8_MeshCacheSectionInfo {
+  uint64_t offset;
+  uint64_t size;
+};
+
+// On-disk layout, little endian. Section payloads are the in-memory
+// representations of V8_Vertex, uint32_t, V8_MeshLOD and V8_Meshlet.
+struct V8_MeshCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t vertexStride;
+  uint32_t flags;
+
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t lodCount;
+  uint32_t meshletCount;
+
+  float boundsCenter[3];
+  float boundsRadius;
+
+  V8_MeshCacheSectionInfo sections[static_cast<uint32_t>(V8_MeshCacheSection::Count)];
+};
+
+bool V8_WriteMeshCache(const std::string& path, const V8_StaticMesh& mesh);
+
+// Read-only memory mapping of a mesh cache file. Opening validates the header,
+// the section bounds, every index against the vertex count and the LOD and
+// meshlet index ranges; the payloads are never copied.
+class V8_MeshCacheFile {
+  private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+  public:
+    V8_MeshCacheFile() = default;
+    V8_MeshCacheFile(const V8_MeshCacheFile&) = delete;
+    V8_MeshCacheFile& operator=(const V8_MeshCacheFile&) = delete;
+    ~V8_MeshCacheFile();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const {
+      return data_ != nullptr;
+    }
+
+    const V8_MeshCacheHeader& Header() const {
+      return *reinterpret_cast<const V8_MeshCacheHeader*>(data_);
+    }
+
+    const void* Section(V8_MeshCacheSection section) const {
+      return data_ + Header().sections[static_cast<uint32_t>(section)].offset;
+    }
+
+    uint64_t SectionSize(V8_MeshCacheSection section) const {
+      return Header().sections[static_cast<uint32_t>(section)].size;
+    }
+};
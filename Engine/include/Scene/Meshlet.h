@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Scene/Types.h>
+
+#include <cstdint>
+#include <vector>
+
+// Push constants of shaders/cull.comp. Planes and camera are in the mesh's object space.
+struct V8_MeshletCullParams {
+  glm::vec4 frustumPlanes[6];
+  glm::vec4 cameraPosition;
+  uint32_t meshletCount;
+  uint32_t firstCommand; // where this draw's commands start in the output buffer
+};
+
+// Splits [indexOffset, indexOffset + indexCount) of indices into meshlets of
+// consecutive triangles, so no index reordering is needed to draw them.
+std::vector<V8_Meshlet> V8_BuildMeshlets(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t indexOffset, uint32_t indexCount, uint32_t maxVertices = V8_MESHLET_MAX_VERTICES, uint32_t maxTriangles = V8_MESHLET_MAX_TRIANGLES);
+
+// Extracts normalized object-space frustum planes from a model-view-projection matrix
+void V8_ExtractFrustumPlanes(const Matrix4& modelViewProjection, glm::vec4 planes[6]);
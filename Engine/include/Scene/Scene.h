@@ -4,18 +4,28 @@
 #include <Scene/Camera.h>
 #include <Core/Entity.h>
 
+// Hierarchy component attached by the importer. worldTransform is resolved at
+// import time from the parent chain.
+struct V8_SceneNode {
+  std::string name;
+  V8_Entity parent = V8_INVALID_ENTITY;
+  std::vector<V8_Entity> children;
+  Matrix4 localTransform = Matrix4(1.0f);
+  Matrix4 worldTransform = Matrix4(1.0f);
+};
+
 struct V8_Scene {
-  V8_Camera* cam;
+  V8_Camera* cam = nullptr;
   V8_EntityRegistry registry;
 
   V8_Scene() {}
 };
 
 struct V8_SceneManager {
-  std::unordered_map<std::string, V8_Scene> scenes;
+  V8_PooledMap<std::string, V8_Scene> scenes;
 
   void AddScene(const std::string& name) {
-    scenes[name] = V8_Scene();
+    scenes.insert_or_assign(name, V8_Scene());
   }
 
   void BindCamera(const std::string& scene, V8_Camera* cam) {
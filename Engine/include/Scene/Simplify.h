@@ -0,0 +1,16 @@
+#pragma once
+
+#include <Scene/Types.h>
+
+#include <cstdint>
+#include <vector>
+
+// Quadric-error edge-collapse simplification. Vertices are only ever collapsed
+// onto existing vertices, so the result indexes the same vertex buffer as the
+// input. Vertices with identical attributes are welded first. Vertices on open
+// borders or where more than two attribute sets meet are locked, and vertices on
+// a seam between two attribute sets only collapse along it, pairwise.
+//
+// targetError is an object-space distance; the error actually introduced is
+// written to resultError when provided.
+std::vector<uint32_t> V8_SimplifyMesh(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float targetError, float* resultError = nullptr);
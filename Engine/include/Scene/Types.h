@@ -55,20 +55,71 @@ struct V8_Vertex {
   }
 };
 
+#define V8_MAX_MESH_LODS 8
+
+struct V8_Camera;
+class V8_MeshCacheFile;
+
+// A level of detail as a range of the mesh's shared index buffer
+struct V8_MeshLOD {
+  uint32_t indexOffset = 0;
+  uint32_t indexCount = 0;
+  float error = 0.0f;
+};
+
+#define V8_MESHLET_MAX_VERTICES 64
+#define V8_MESHLET_MAX_TRIANGLES 124
+
+// A cluster of triangles drawn as one indirect draw. The layout matches the
+// std430 Meshlet struct in shaders/cull.comp.
+struct V8_Meshlet {
+  // Bounding sphere
+  Vector3 center = Vector3(0.0f);
+  float radius = 0.0f;
+
+  // Normal cone; a cutoff of 1 means the cone is too wide to ever cull
+  Vector3 coneAxis = Vector3(0.0f);
+  float coneCutoff = 1.0f;
+  Vector3 coneApex = Vector3(0.0f);
+
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  uint32_t vertexCount = 0;
+  uint32_t padding[2] = { 0, 0 };
+};
+
+static_assert(sizeof(V8_Meshlet) == 64, "V8_Meshlet must match the shader layout");
+
 struct V8_StaticMesh {
   private:
-    VmaAllocator* allocator_;
+    VmaAllocator* allocator_ = nullptr;
 
     void UploadVertexData(V8_Context& context);
     void UploadIndexData(V8_Context& context);
+    void UploadMeshletData(V8_Context& context);
 
   public:
     std::vector<V8_Vertex> vertices;
     std::vector<uint32_t> indices;
 
-    Vector3 position;
-    Vector3 rotation;
-    Vector3 scale;
+    // LOD 0 is the full mesh, each further level is stored after it in indices
+    std::vector<V8_MeshLOD> lods;
+
+    // Clusters of LOD 0, culled on the GPU before drawing
+    std::vector<V8_Meshlet> meshlets;
+
+    Vector3 boundsCenter = Vector3(0.0f);
+    float boundsRadius = 0.0f;
+
+    Vector3 position = Vector3(0.0f);
+    Vector3 rotation = Vector3(0.0f);
+    Vector3 scale = Vector3(1.0f);
+
+    // Transform before the last fixed update, rendering blends from it to the current one
+    Vector3 previousPosition = Vector3(0.0f);
+    Vector3 previousRotation = Vector3(0.0f);
+    Vector3 previousScale = Vector3(1.0f);
+    bool hasPreviousTransform = false;
 
     VmaAllocation vertexBufferAllocation = VK_NULL_HANDLE;
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
@@ -76,10 +127,44 @@ struct V8_StaticMesh {
     VmaAllocation indexBufferAllocation = VK_NULL_HANDLE;
     VkBuffer indexBuffer = VK_NULL_HANDLE;
 
-    void Init(V8_Context& context, const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices);
+    // Read by the culling pass, which writes each draw's commands into the renderer's own buffer
+    VmaAllocation meshletBufferAllocation = VK_NULL_HANDLE;
+    VkBuffer meshletBuffer = VK_NULL_HANDLE;
+
+    void Init(V8_Context& context, const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, bool generateLODs = false);
+    void InitFromCache(V8_Context& context, const V8_MeshCacheFile& cache);
+
+    // Init split in two: Build only touches CPU data and is safe to run on a worker
+    // thread, Upload creates the GPU buffers and must run on the thread owning the context
+    void Build(std::vector<V8_Vertex> vertices, std::vector<uint32_t> indices, bool generateLODs = false);
+    void Upload(V8_Context& context);
+
+    void ComputeBounds();
+
+    // Needs the bounds, Build computes them first
+    void GenerateLODs(uint32_t maxLODs = V8_MAX_MESH_LODS, float reduction = 0.5f);
+    void GenerateMeshlets();
+
+    // Picks the coarsest LOD whose simplification error projects to at most errorThreshold pixels
+    uint32_t SelectLOD(const V8_Camera& camera, float viewportHeight, float errorThreshold = 1.0f) const;
+    Matrix4 GetModelMatrix() const;
+
+    // Interpolates from the stored previous transform, an alpha of 1 is the current transform
+    Matrix4 GetModelMatrix(float alpha) const;
+
+    void StoreTransform() {
+      previousPosition = position;
+      previousRotation = rotation;
+      previousScale = scale;
+      hasPreviousTransform = true;
+    }
+
+    // Records the uploads into the context's staging ring and submits them without waiting
     void UploadData(V8_Context& context) {
       UploadVertexData(context);
       UploadIndexData(context);
+      UploadMeshletData(context);
+      context.stagingRing_.Submit();
     }
 
     ~V8_StaticMesh();
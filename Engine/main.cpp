@@ -6,6 +6,9 @@ class MyApp : public V8_Application {
     V8_Scene scene_;
     V8_SceneManager sceneManager_;
 
+    // Looks down -z at the quad, and gives meshlet culling a view to cull against
+    V8_Camera camera_ { .position = { 0.0f, 0.0f, 1.0f }, .front = { 0.0f, 0.0f, -1.0f }, .up = { 0.0f, 1.0f, 0.0f }, .right = { 1.0f, 0.0f, 0.0f }, .worldUp = { 0.0f, 1.0f, 0.0f }, .zoom = 90.0f };
+
     void OnInitPre() override {
       V_INFO("initializing");
       config_.appName = "My Vulkan App";
@@ -13,6 +16,9 @@ class MyApp : public V8_Application {
       config_.windowHeight = 600;
       config_.resizable = true;
       config_.enableVSync = true;
+
+      renderManager_.PreloadShader("../shaders/vert.spv");
+      renderManager_.PreloadShader("../shaders/frag.spv");
     }
 
     void OnInitPost() override {
@@ -33,6 +39,7 @@ class MyApp : public V8_Application {
       sceneManager_.AddScene("main");
       V8_Entity entity = sceneManager_.AddEntity("main");
       sceneManager_.AddComponent<V8_StaticMesh>("main", entity, mesh);
+      sceneManager_.BindCamera("main", &camera_);
 
       renderManager_.BindScene("default", &sceneManager_.GetScene("main"));
     }
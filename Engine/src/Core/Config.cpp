@@ -16,5 +16,23 @@ V8_CoreConfig defaultConfig = {
   .windowHeight = 720,
   .enableVSync = false,
   .fullscreen = false,
-  .resizable = false
+  .resizable = false,
+  .stagingBufferSize = 64ull * 1024 * 1024,
+  .assetMemoryBudget = 512ull * 1024 * 1024,
+  .assetUploadBytesPerFrame = 16ull * 1024 * 1024,
+  .assetIOThreads = 2,
+  .profileTracePath = "",
+  .frameStatsCapacity = 1024,
+  .frameStatsReportInterval = 5.0,
+  .frameStatsCsvPath = "",
+  .headless = false,
+  .maxFrames = 0,
+  .pipelineCachePath = "",
+  .renderThread = false,
+  .fixedUpdateRate = 0,
+  .maxFixedSteps = 5,
+  .targetFrameRate = 0.0,
+  .immediatePresent = false,
+  .lowLatency = false,
+  .frameAllocatorBlockSize = 1024 * 1024
 };
@@ -1,5 +1,13 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Vulkan
+
 #include <Core/Context.h>
+#include <Core/Profiler.h>
+#include <Core/Startup.h>
 
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <set>
 
 #define VMA_IMPLEMENTATION
@@ -31,16 +39,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
     void* pUserData) {
   switch(messageSeverity) {
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-      V_DEBUG("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_DEBUG_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-      V_INFO("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_INFO_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-      V_WARNING("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_WARNING_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-      V_ERROR("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_ERROR_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     default:
       break;
@@ -77,8 +85,12 @@ QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surfa
     if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) 
       indices.graphicsFamily = i;
 
+    // Without a surface nothing is presented, the graphics queue stands in for the present queue
     VkBool32 presentSupport = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+    if (surface != VK_NULL_HANDLE)
+      vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+    else
+      presentSupport = (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
 
     if (presentSupport) 
       indices.presentFamily = i;
@@ -125,10 +137,17 @@ VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>
   return availableFormats[0];
 }
 
-VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, bool enableVSync) {
+// IMMEDIATE shows a frame as soon as it is done and may tear, MAILBOX waits for vblank without blocking the CPU
+VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, bool enableVSync, bool immediate) {
   if (enableVSync) {
     return VK_PRESENT_MODE_FIFO_KHR;
   } else {
+    VkPresentModeKHR preferred = immediate ? VK_PRESENT_MODE_IMMEDIATE_KHR : VK_PRESENT_MODE_MAILBOX_KHR;
+    for (const auto& availablePresentMode : availablePresentModes) {
+      if (availablePresentMode == preferred) 
+        return availablePresentMode;
+    }
+
     for (const auto& availablePresentMode : availablePresentModes) {
       if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) 
         return availablePresentMode;
@@ -137,6 +156,21 @@ VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& avai
   }
 }
 
+bool SupportsDeviceExtension(VkPhysicalDevice device, const char* name) {
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+  std::vector<VkExtensionProperties> extensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+
+  for (const auto& extension : extensions) {
+    if (strcmp(extension.extensionName, name) == 0)
+      return true;
+  }
+
+  return false;
+}
+
 VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, uint32_t windowWidth, uint32_t windowHeight) {
   if (capabilities.currentExtent.width != UINT32_MAX) {
     return capabilities.currentExtent;
@@ -170,6 +204,8 @@ uint32_t RatePhysicalDevice(VkPhysicalDevice device, VkSurfaceKHR surface) {
   QueueFamilyIndices indices = FindQueueFamilies(device, surface);
   if (!indices.Complete()) return 0;
 
+  if (surface == VK_NULL_HANDLE) return score;
+
   SwapchainSupportDetails swapchainSupport = QuerySwapchainSupport(device, surface);
   if (!swapchainSupport.Adequate()) return 0;
 
@@ -191,6 +227,22 @@ VkPhysicalDevice ChooseBestPhysicalDevice(const std::vector<VkPhysicalDevice>& d
   return bestDevice;
 }
 
+// Runs on a worker while the instance and device come up. A missing file is the normal first run.
+std::vector<char> ReadPipelineCache(const std::string& path) {
+  uint64_t start = V8_Profiler::Now();
+
+  std::vector<char> data;
+  std::ifstream file(path, std::ios::ate | std::ios::binary);
+  if (file.is_open()) {
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), data.size());
+  }
+
+  startupTimeline.Record("Pipeline cache read", start, V8_Profiler::Now());
+  return data;
+}
+
 void PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
   createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
@@ -204,9 +256,11 @@ void PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& create
 }
 
 void V8_Context::CreateSwapchain() {
+  V_PROFILE_FUNCTION();
+
   SwapchainSupportDetails swapchainSupport = QuerySwapchainSupport(physicalDevice_, surface_);
   VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapchainSupport.formats);
-  VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapchainSupport.presentModes, config_.enableVSync);
+  VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapchainSupport.presentModes, config_.enableVSync, config_.immediatePresent);
   VkExtent2D extent = ChooseSwapExtent(swapchainSupport.capabilities, config_.windowWidth, config_.windowHeight);
 
   uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
@@ -240,7 +294,7 @@ void V8_Context::CreateSwapchain() {
   swapchainCreateInfo.clipped = VK_TRUE;
   swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
 
-  VK_CHECK(vkCreateSwapchainKHR(device_, &swapchainCreateInfo, nullptr, &swapchain_));
+  VK_CHECK(vkCreateSwapchainKHR(device_, &swapchainCreateInfo, V8_VulkanAllocator(), &swapchain_));
 
   swapchainImageFormat_ = surfaceFormat.format;
   swapchainExtent_ = extent;
@@ -251,7 +305,44 @@ void V8_Context::CreateSwapchain() {
   swapchainImages_.resize(imageCount);
   vkGetSwapchainImagesKHR(device_, swapchain_, &imageCount, swapchainImages_.data());
 
-  // Create image views for swapchain images
+  CreateImageViews();
+}
+
+void V8_Context::CreateOffscreenImages() {
+  V_PROFILE_FUNCTION();
+
+  // Matches a typical swapchain's minImageCount + 1, so frames in flight behave the same
+  constexpr uint32_t imageCount = 3;
+
+  swapchainImageFormat_ = VK_FORMAT_R8G8B8A8_SRGB;
+  swapchainExtent_ = { config_.windowWidth, config_.windowHeight };
+
+  VkImageCreateInfo imageInfo {};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = swapchainImageFormat_;
+  imageInfo.extent = { swapchainExtent_.width, swapchainExtent_.height, 1 };
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  VmaAllocationCreateInfo allocInfo {};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+  swapchainImages_.assign(imageCount, VK_NULL_HANDLE);
+  offscreenAllocations_.assign(imageCount, VK_NULL_HANDLE);
+  for (uint32_t i = 0; i < imageCount; i++)
+    VK_CHECK(vmaCreateImage(allocator_, &imageInfo, &allocInfo, &swapchainImages_[i], &offscreenAllocations_[i], nullptr));
+
+  CreateImageViews();
+}
+
+void V8_Context::CreateImageViews() {
   swapchainImageViews_.clear();
   swapchainImageViews_.resize(swapchainImages_.size());
   for (size_t i = 0; i < swapchainImages_.size(); i++) {
@@ -270,7 +361,7 @@ void V8_Context::CreateSwapchain() {
     viewCreateInfo.subresourceRange.baseArrayLayer = 0;
     viewCreateInfo.subresourceRange.layerCount = 1;
 
-    VK_CHECK(vkCreateImageView(device_, &viewCreateInfo, nullptr, &swapchainImageViews_[i]));
+    VK_CHECK(vkCreateImageView(device_, &viewCreateInfo, V8_VulkanAllocator(), &swapchainImageViews_[i]));
   }
 }
 
@@ -287,17 +378,79 @@ void V8_Context::CreateSyncObjects() {
   fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
   for (size_t i = 0; i < swapchainImages_.size(); i++) {
-    VK_CHECK(vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &imageAvailableSemaphores_[i]));
-    VK_CHECK(vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &renderFinishedSemaphores_[i]));
-    VK_CHECK(vkCreateFence(device_, &fenceInfo, nullptr, &inFlightFences_[i]));
+    VK_CHECK(vkCreateSemaphore(device_, &semaphoreInfo, V8_VulkanAllocator(), &imageAvailableSemaphores_[i]));
+    VK_CHECK(vkCreateSemaphore(device_, &semaphoreInfo, V8_VulkanAllocator(), &renderFinishedSemaphores_[i]));
+    VK_CHECK(vkCreateFence(device_, &fenceInfo, V8_VulkanAllocator(), &inFlightFences_[i]));
+  }
+}
+
+void V8_Context::CreatePipelineCache(const std::vector<char>& data) {
+  VkPipelineCacheCreateInfo cacheInfo {};
+  cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+  // Drivers ignore data from another device themselves, checking the header keeps that case visible in the log
+  if (data.size() >= sizeof(VkPipelineCacheHeaderVersionOne)) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice_, &properties);
+
+    VkPipelineCacheHeaderVersionOne header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.vendorID == properties.vendorID &&
+        header.deviceID == properties.deviceID && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0) {
+      cacheInfo.initialDataSize = data.size();
+      cacheInfo.pInitialData = data.data();
+    } else {
+      V_INFO("Pipeline cache {} is from another device or driver, starting empty", config_.pipelineCachePath);
+    }
   }
+
+  VK_CHECK(vkCreatePipelineCache(device_, &cacheInfo, V8_VulkanAllocator(), &pipelineCache_));
+}
+
+void V8_Context::SavePipelineCache() {
+  if (pipelineCache_ == VK_NULL_HANDLE || config_.pipelineCachePath.empty())
+    return;
+
+  size_t size = 0;
+  VK_CHECK(vkGetPipelineCacheData(device_, pipelineCache_, &size, nullptr));
+
+  std::vector<char> data(size);
+  VK_CHECK(vkGetPipelineCacheData(device_, pipelineCache_, &size, data.data()));
+
+  // Written beside the target and renamed over it, so an interrupted write never leaves a truncated cache
+  std::string tempPath = config_.pipelineCachePath + ".tmp";
+  std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    V_WARNING("Failed to write pipeline cache {}", tempPath);
+    return;
+  }
+
+  file.write(data.data(), size);
+  file.close();
+
+  std::error_code error;
+  std::filesystem::rename(tempPath, config_.pipelineCachePath, error);
+  if (error)
+    V_WARNING("Failed to replace pipeline cache {}: {}", config_.pipelineCachePath, error.message());
 }
 
 void V8_Context::Init(const V8_CoreConfig& config) {
+  V_PROFILE_FUNCTION();
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
   config_ = config;
 
+  // The cache file is only needed once the device exists, read it in the meantime
+  std::future<std::vector<char>> pipelineCacheData;
+  if (!config_.pipelineCachePath.empty())
+    pipelineCacheData = std::async(std::launch::async, ReadPipelineCache, config_.pipelineCachePath);
+
   // Initialize the window
-  window_.Init(config_.windowWidth, config_.windowHeight, config_.appName.c_str(), config_.resizable, config_.fullscreen);
+  if (!config_.headless)
+    window_.Init(config_.windowWidth, config_.windowHeight, config_.appName.c_str(), config_.resizable, config_.fullscreen);
+
+  startupTimeline.Mark("Window");
 
   // Create Vulkan instance
   VkApplicationInfo appInfo {};
@@ -312,13 +465,13 @@ void V8_Context::Init(const V8_CoreConfig& config) {
   instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
   instanceInfo.pApplicationInfo = &appInfo;
 
-  // Get required extensions from SDL2
+  // Get required extensions from SDL2, headless mode needs no surface extensions
   uint32_t sdlExtensionCount = 0;
-  if (!SDL_Vulkan_GetInstanceExtensions(window_.Get(), &sdlExtensionCount, nullptr)) 
+  if (!config_.headless && !SDL_Vulkan_GetInstanceExtensions(window_.Get(), &sdlExtensionCount, nullptr)) 
     V_FATAL("Failed to get the number of required Vulkan extensions from SDL: {}", SDL_GetError());
 
   std::vector<const char*> extensions(sdlExtensionCount);
-  if (!SDL_Vulkan_GetInstanceExtensions(window_.Get(), &sdlExtensionCount, extensions.data())) 
+  if (!config_.headless && !SDL_Vulkan_GetInstanceExtensions(window_.Get(), &sdlExtensionCount, extensions.data())) 
     V_FATAL("Failed to get the required Vulkan extensions from SDL: {}", SDL_GetError());
 
   if (config_.enableValidationLayers) 
@@ -344,14 +497,17 @@ void V8_Context::Init(const V8_CoreConfig& config) {
     instanceInfo.enabledLayerCount = 0;
   }
 
-  VK_CHECK(vkCreateInstance(&instanceInfo, nullptr, &instance_));
+  VK_CHECK(vkCreateInstance(&instanceInfo, V8_VulkanAllocator(), &instance_));
 
   V_INFO("Vulkan instance created successfully.");
+  startupTimeline.Mark("Instance");
 
   // Create Vulkan surface
-  if (!SDL_Vulkan_CreateSurface(window_.Get(), instance_, &surface_)) 
+  if (!config_.headless && !SDL_Vulkan_CreateSurface(window_.Get(), instance_, &surface_)) 
     V_FATAL("Failed to create Vulkan surface: {}", SDL_GetError());
 
+  startupTimeline.Mark("Surface");
+
   // Select physical device
   uint32_t deviceCount = 0;
   vkEnumeratePhysicalDevices(instance_, &deviceCount, nullptr);
@@ -375,6 +531,8 @@ void V8_Context::Init(const V8_CoreConfig& config) {
   graphicsQueueFamilyIndex_ = indices.graphicsFamily;
   presentQueueFamilyIndex_ = indices.presentFamily;
 
+  startupTimeline.Mark("Physical device");
+
   std::set<uint32_t> uniqueQueueFamilies = {
     (uint32_t) indices.graphicsFamily,
     (uint32_t) indices.presentFamily
@@ -383,9 +541,38 @@ void V8_Context::Init(const V8_CoreConfig& config) {
   VkDeviceCreateInfo deviceCreateInfo {};
   deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 
+  VkPhysicalDeviceFeatures supportedFeatures {};
+  vkGetPhysicalDeviceFeatures(physicalDevice_, &supportedFeatures);
+
+  // Meshlet draws are issued as one multi-draw when available
   VkPhysicalDeviceFeatures enabledFeatures {};
+  enabledFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+  enabledFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
   deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 
+  multiDrawIndirect_ = supportedFeatures.multiDrawIndirect == VK_TRUE;
+  pipelineStatisticsQuery_ = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
+
+  // Present wait lets the frame loop block until a frame is on screen, see V8_Renderer::WaitForFrame
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures {};
+  presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures {};
+  presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+  presentIdFeatures.pNext = &presentWaitFeatures;
+
+  if (!config_.headless && SupportsDeviceExtension(physicalDevice_, VK_KHR_PRESENT_ID_EXTENSION_NAME) && SupportsDeviceExtension(physicalDevice_, VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+    VkPhysicalDeviceFeatures2 features2 {};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &presentIdFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice_, &features2);
+
+    presentWait_ = presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+  }
+
+  if (presentWait_)
+    deviceCreateInfo.pNext = &presentIdFeatures;
+
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos(uniqueQueueFamilies.size());
   float queuePriority = 1.0f;
   for (size_t i = 0; i < uniqueQueueFamilies.size(); i++) {
@@ -402,22 +589,39 @@ void V8_Context::Init(const V8_CoreConfig& config) {
   std::vector<const char*> deviceExtensions = config_.deviceExtensions;
   if (strcmp(PLATFORM, "macOS") == 0) 
     deviceExtensions.push_back("VK_KHR_portability_subset");
+
+  // Software drivers used on CI may not expose the swapchain extension at all
+  if (config_.headless)
+    std::erase_if(deviceExtensions, [](const char* name) { return strcmp(name, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0; });
+
+  if (presentWait_) {
+    deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+  }
     
   deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
   deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
-  VK_CHECK(vkCreateDevice(physicalDevice_, &deviceCreateInfo, nullptr, &device_));
+  VK_CHECK(vkCreateDevice(physicalDevice_, &deviceCreateInfo, V8_VulkanAllocator(), &device_));
 
   vkGetDeviceQueue(device_, graphicsQueueFamilyIndex_, 0, &graphicsQueue_);
   vkGetDeviceQueue(device_, presentQueueFamilyIndex_, 0, &presentQueue_);
 
+  if (presentWait_)
+    waitForPresent_ = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(device_, "vkWaitForPresentKHR");
+
+  startupTimeline.Mark("Device");
+
   VmaAllocatorCreateInfo allocatorInfo {};
   allocatorInfo.physicalDevice = physicalDevice_;
   allocatorInfo.device = device_;
   allocatorInfo.instance = instance_;
+  allocatorInfo.pAllocationCallbacks = V8_VulkanAllocator();
 
   VK_CHECK(vmaCreateAllocator(&allocatorInfo, &allocator_));
 
+  startupTimeline.Mark("Allocator");
+
   // Create command pools
   commandPools_.reserve(uniqueQueueFamilies.size());
   for (const auto& queueFamily : uniqueQueueFamilies) {
@@ -426,22 +630,37 @@ void V8_Context::Init(const V8_CoreConfig& config) {
     poolInfo.queueFamilyIndex = queueFamily;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-    VK_CHECK(vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPools_[queueFamily]));
+    VK_CHECK(vkCreateCommandPool(device_, &poolInfo, V8_VulkanAllocator(), &commandPools_[queueFamily]));
   }
 
+  stagingRing_.Init(device_, allocator_, graphicsQueue_, commandPools_[graphicsQueueFamilyIndex_], config_.stagingBufferSize);
+
+  startupTimeline.Mark("Command pools");
+
+  CreatePipelineCache(pipelineCacheData.valid() ? pipelineCacheData.get() : std::vector<char> {});
+
+  startupTimeline.Mark("Pipeline cache");
+
   // Create swapchain
-  CreateSwapchain();
+  if (config_.headless)
+    CreateOffscreenImages();
+  else
+    CreateSwapchain();
 
   // Create synchronization objects
   CreateSyncObjects();
 
+  startupTimeline.Mark("Swapchain");
+
   // Setup debug messenger if validation layers are enabled
   if (!config_.enableValidationLayers) return;
 
   VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo {};
   PopulateDebugMessengerCreateInfo(debugCreateInfo);
 
-  VK_CHECK(CreateDebugUtilsMessengerEXT(instance_, &debugCreateInfo, nullptr, &debugMessenger_));
+  VK_CHECK(CreateDebugUtilsMessengerEXT(instance_, &debugCreateInfo, V8_VulkanAllocator(), &debugMessenger_));
+
+  startupTimeline.Mark("Debug messenger");
 }
 
 V8_Context::~V8_Context() {
@@ -450,22 +669,29 @@ V8_Context::~V8_Context() {
   CleanupSyncObjects();
   CleanupSwapchain();
 
+  stagingRing_.Shutdown();
+
+  SavePipelineCache();
+  if (pipelineCache_ != VK_NULL_HANDLE)
+    vkDestroyPipelineCache(device_, pipelineCache_, V8_VulkanAllocator());
+
   for (const auto& [_, pool] : commandPools_)
-    vkDestroyCommandPool(device_, pool, nullptr);
+    vkDestroyCommandPool(device_, pool, V8_VulkanAllocator());
   
   vmaDestroyAllocator(allocator_);
 
   if (device_ != VK_NULL_HANDLE) 
-    vkDestroyDevice(device_, nullptr);
+    vkDestroyDevice(device_, V8_VulkanAllocator());
 
+  // SDL creates the surface without allocation callbacks
   if (surface_ != VK_NULL_HANDLE) 
     vkDestroySurfaceKHR(instance_, surface_, nullptr);
 
   if (config_.enableValidationLayers)
-    DestroyDebugUtilsMessengerEXT(instance_, debugMessenger_, nullptr);
+    DestroyDebugUtilsMessengerEXT(instance_, debugMessenger_, V8_VulkanAllocator());
 
   if (instance_ != VK_NULL_HANDLE) 
-    vkDestroyInstance(instance_, nullptr);
+    vkDestroyInstance(instance_, V8_VulkanAllocator());
 }
 
 void V8_Context::HandleResize(uint32_t newWidth, uint32_t newHeight) {
@@ -474,6 +700,95 @@ void V8_Context::HandleResize(uint32_t newWidth, uint32_t newHeight) {
   CleanupSyncObjects();
   CleanupSwapchain();
 
-  CreateSwapchain();
+  if (config_.headless)
+    CreateOffscreenImages();
+  else
+    CreateSwapchain();
+
   CreateSyncObjects();
 }
+
+bool V8_Context::ReadbackImage(uint32_t index, VkImageLayout layout, std::vector<uint8_t>& pixels) {
+  if (index >= offscreenAllocations_.size()) {
+    V_ERROR("Image readback needs headless mode and a valid image index, got {}", index);
+    return false;
+  }
+
+  VkDeviceSize size = static_cast<VkDeviceSize>(swapchainExtent_.width) * swapchainExtent_.height * 4;
+
+  VkBufferCreateInfo bufferInfo {};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = size;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo {};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VkBuffer buffer;
+  VmaAllocation allocation;
+  VmaAllocationInfo allocationInfo {};
+  VK_CHECK(vmaCreateBuffer(allocator_, &bufferInfo, &allocInfo, &buffer, &allocation, &allocationInfo));
+
+  VkCommandBufferAllocateInfo cmdAllocInfo {};
+  cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  cmdAllocInfo.commandPool = commandPools_[graphicsQueueFamilyIndex_];
+  cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  cmdAllocInfo.commandBufferCount = 1;
+
+  VkCommandBuffer cmd;
+  VK_CHECK(vkAllocateCommandBuffers(device_, &cmdAllocInfo, &cmd));
+
+  VkCommandBufferBeginInfo beginInfo {};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+  VkImageMemoryBarrier barrier {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  barrier.oldLayout = layout;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = swapchainImages_[index];
+  barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+  VkBufferImageCopy region {};
+  region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+  region.imageExtent = { swapchainExtent_.width, swapchainExtent_.height, 1 };
+  vkCmdCopyImageToBuffer(cmd, swapchainImages_[index], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+  // Hand the image back in the layout the next render pass expects to find it in
+  if (layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL && layout != VK_IMAGE_LAYOUT_UNDEFINED) {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = layout;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+  }
+
+  VK_CHECK(vkEndCommandBuffer(cmd));
+
+  VkSubmitInfo submitInfo {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &cmd;
+
+  // Also covers the frame that rendered the image
+  VK_CHECK(vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE));
+  vkQueueWaitIdle(graphicsQueue_);
+
+  vmaInvalidateAllocation(allocator_, allocation, 0, VK_WHOLE_SIZE);
+
+  const uint8_t* mapped = static_cast<const uint8_t*>(allocationInfo.pMappedData);
+  pixels.assign(mapped, mapped + size);
+
+  vkFreeCommandBuffers(device_, commandPools_[graphicsQueueFamilyIndex_], 1, &cmd);
+  vmaDestroyBuffer(allocator_, buffer, allocation);
+  return true;
+}
@@ -0,0 +1,58 @@
+#include <Core/FrameAllocator.h>
+
+#include <algorithm>
+
+V8_FrameAllocator frameAllocator;
+
+void V8_FrameAllocator::Init(uint32_t regionCount, size_t blockSize) {
+  regionCount_ = std::max(regionCount, 2u);
+  blockSize_ = blockSize;
+}
+
+V8_FrameAllocator::ThreadArena* V8_FrameAllocator::LocalArena() {
+  thread_local ThreadArena* arena = nullptr;
+  if (arena != nullptr)
+    return arena;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  arena = arenas_.emplace_back(std::make_unique<ThreadArena>()).get();
+  return arena;
+}
+
+void* V8_FrameAllocator::Allocate(size_t size, size_t alignment) {
+  ThreadArena* arena = LocalArena();
+
+  uint64_t frame = frame_.load(std::memory_order_acquire);
+  if (arena->frame != frame) {
+    if (arena->regions.size() != regionCount_)
+      arena->regions.resize(regionCount_);
+
+    arena->frame = frame;
+    arena->region = static_cast<uint32_t>(frame % regionCount_);
+    arena->regions[arena->region].block = 0;
+    arena->regions[arena->region].offset = 0;
+  }
+
+  Region& region = arena->regions[arena->region];
+
+  for (; region.block < region.blocks.size(); region.block++, region.offset = 0) {
+    Block& block = region.blocks[region.block];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+    size_t offset = ((base + region.offset + alignment - 1) & ~(alignment - 1)) - base;
+
+    if (offset + size <= block.size) {
+      region.offset = offset + size;
+      return block.data.get() + offset;
+    }
+  }
+
+  // Only reached while a region grows towards its high-water mark
+  size_t blockSize = std::max(blockSize_, size + alignment);
+  Block& block = region.blocks.emplace_back(Block { std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize });
+  region.block = region.blocks.size() - 1;
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+  size_t offset = ((base + alignment - 1) & ~(alignment - 1)) - base;
+  region.offset = offset + size;
+  return block.data.get() + offset;
+}
@@ -0,0 +1,35 @@
+#include <Core/FrameLimiter.h>
+#include <Core/Profiler.h>
+
+#include <thread>
+
+namespace {
+  // Long enough to cover sleep overshoot on Linux and macOS, Windows timers may need more
+  constexpr uint64_t spinNanoseconds = 2'000'000;
+}
+
+void V8_FrameLimiter::Init(double targetFrameRate) {
+  interval_ = targetFrameRate > 0.0 ? static_cast<uint64_t>(1e9 / targetFrameRate) : 0;
+  next_ = 0;
+}
+
+void V8_FrameLimiter::Wait() {
+  if (interval_ == 0)
+    return;
+
+  V_PROFILE_SCOPE("Frame limiter");
+
+  uint64_t now = V8_Profiler::Now();
+  if (next_ == 0 || now > next_ + interval_) {
+    next_ = now + interval_;
+    return;
+  }
+
+  if (next_ > now + spinNanoseconds)
+    std::this_thread::sleep_for(std::chrono::nanoseconds(next_ - now - spinNanoseconds));
+
+  while (V8_Profiler::Now() < next_)
+    std::this_thread::yield();
+
+  next_ += interval_;
+}
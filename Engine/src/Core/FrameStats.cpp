@@ -0,0 +1,111 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Core
+
+#include <Core/FrameStats.h>
+#include <Core/Logger.h>
+
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+
+namespace {
+  constexpr const char* phaseNames[] = { "total", "update", "record", "submit", "wait", "latency" };
+  static_assert(std::size(phaseNames) == static_cast<size_t>(V8_FramePhase::Count));
+}
+
+void V8_FrameStats::Init(uint32_t capacity, double reportInterval, const std::string& csvPath) {
+  samples_.assign(std::max(capacity, 1u), {});
+  scratch_.reserve(samples_.size());
+  reportInterval_ = reportInterval;
+  Clear();
+
+  if (csvPath.empty())
+    return;
+
+  csv_.open(csvPath, std::ios::trunc);
+  if (!csv_.is_open()) {
+    V_ERROR("Failed to open {} for frame statistics", csvPath);
+    return;
+  }
+
+  csv_ << "time,frames";
+  for (const char* name : phaseNames)
+    csv_ << ',' << name << "_mean," << name << "_p50," << name << "_p95," << name << "_p99," << name << "_max";
+  csv_ << '\n';
+}
+
+void V8_FrameStats::Clear() {
+  next_ = 0;
+  count_ = 0;
+  sinceReport_ = 0.0;
+}
+
+void V8_FrameStats::Add(const V8_FrameSample& sample) {
+  if (samples_.empty())
+    return;
+
+  samples_[next_] = sample;
+  next_ = (next_ + 1) % samples_.size();
+  count_ = std::min(count_ + 1, samples_.size());
+
+  double seconds = sample[V8_FramePhase::Total] / 1000.0;
+  elapsed_ += seconds;
+
+  if (reportInterval_ <= 0.0)
+    return;
+
+  sinceReport_ += seconds;
+  if (sinceReport_ < reportInterval_)
+    return;
+
+  sinceReport_ = 0.0;
+  Report();
+
+  if (csv_.is_open())
+    WriteCsvRow();
+}
+
+V8_FrameSummary V8_FrameStats::Summarize(V8_FramePhase phase) const {
+  V8_FrameSummary summary;
+  if (count_ == 0)
+    return summary;
+
+  scratch_.clear();
+  double sum = 0.0;
+  for (size_t i = 0; i < count_; i++) {
+    double ms = samples_[i][phase];
+    scratch_.push_back(ms);
+    sum += ms;
+  }
+
+  std::sort(scratch_.begin(), scratch_.end());
+
+  auto rank = [&](double p) {
+    size_t index = static_cast<size_t>(std::ceil(p * scratch_.size()));
+    return scratch_[std::clamp<size_t>(index, 1, scratch_.size()) - 1];
+  };
+
+  summary.mean = sum / count_;
+  summary.p50 = rank(0.50);
+  summary.p95 = rank(0.95);
+  summary.p99 = rank(0.99);
+  summary.max = scratch_.back();
+  return summary;
+}
+
+void V8_FrameStats::Report() const {
+  for (uint32_t i = 0; i < static_cast<uint32_t>(V8_FramePhase::Count); i++) {
+    V8_FrameSummary s = Summarize(static_cast<V8_FramePhase>(i));
+    V_REPORT("{} over {} frames: mean {:.2f} ms, p50 {:.2f}, p95 {:.2f}, p99 {:.2f}, max {:.2f}", phaseNames[i], count_, s.mean, s.p50, s.p95, s.p99, s.max);
+  }
+}
+
+void V8_FrameStats::WriteCsvRow() {
+  csv_ << elapsed_ << ',' << count_;
+  for (uint32_t i = 0; i < static_cast<uint32_t>(V8_FramePhase::Count); i++) {
+    V8_FrameSummary s = Summarize(static_cast<V8_FramePhase>(i));
+    csv_ << ',' << s.mean << ',' << s.p50 << ',' << s.p95 << ',' << s.p99 << ',' << s.max;
+  }
+
+  csv_ << '\n';
+  csv_.flush();
+}
@@ -0,0 +1,274 @@
+#include <Core/Json.h>
+
+#include <charconv>
+#include <cstdlib>
+
+namespace {
+  const V8_JsonValue nullValue {};
+
+  // Nesting is bounded so a hostile file can't exhaust the stack
+  constexpr uint32_t maxDepth = 256;
+
+  struct Parser {
+    std::string_view text;
+    size_t pos = 0;
+    std::string error;
+
+    bool Fail(const char* message) {
+      if (error.empty())
+        error = std::string(message) + " at offset " + std::to_string(pos);
+      return false;
+    }
+
+    void SkipWhitespace() {
+      while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+        pos++;
+    }
+
+    bool Consume(std::string_view literal) {
+      if (text.substr(pos, literal.size()) != literal)
+        return false;
+
+      pos += literal.size();
+      return true;
+    }
+
+    static void AppendUtf8(std::string& out, uint32_t codepoint) {
+      if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+      } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+      } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+      } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+      }
+    }
+
+    bool ParseHex4(uint32_t& out) {
+      if (pos + 4 > text.size())
+        return Fail("truncated unicode escape");
+
+      auto result = std::from_chars(text.data() + pos, text.data() + pos + 4, out, 16);
+      if (result.ptr != text.data() + pos + 4)
+        return Fail("invalid unicode escape");
+
+      pos += 4;
+      return true;
+    }
+
+    bool ParseString(std::string& out) {
+      pos++; // opening quote
+
+      while (pos < text.size()) {
+        char c = text[pos++];
+
+        if (c == '"')
+          return true;
+
+        if (c != '\\') {
+          out += c;
+          continue;
+        }
+
+        if (pos >= text.size())
+          break;
+
+        char escape = text[pos++];
+        switch (escape) {
+          case '"': out += '"'; break;
+          case '\\': out += '\\'; break;
+          case '/': out += '/'; break;
+          case 'b': out += '\b'; break;
+          case 'f': out += '\f'; break;
+          case 'n': out += '\n'; break;
+          case 'r': out += '\r'; break;
+          case 't': out += '\t'; break;
+          case 'u': {
+            uint32_t codepoint;
+            if (!ParseHex4(codepoint))
+              return false;
+
+            if (codepoint >= 0xD800 && codepoint < 0xDC00 && Consume("\\u")) {
+              uint32_t low;
+              if (!ParseHex4(low))
+                return false;
+
+              codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            AppendUtf8(out, codepoint);
+            break;
+          }
+          default:
+            return Fail("invalid escape sequence");
+        }
+      }
+
+      return Fail("unterminated string");
+    }
+
+    bool ParseNumber(V8_JsonValue& out) {
+      size_t start = pos;
+      if (pos < text.size() && text[pos] == '-')
+        pos++;
+
+      while (pos < text.size()) {
+        char c = text[pos];
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+          pos++;
+        else
+          break;
+      }
+
+      // strtod needs a terminated buffer, numbers are short so copy them
+      std::string literal(text.substr(start, pos - start));
+      char* end = nullptr;
+      out.number = std::strtod(literal.c_str(), &end);
+
+      if (literal.empty() || end != literal.c_str() + literal.size())
+        return Fail("invalid number");
+
+      out.type = V8_JsonValue::Type::Number;
+      return true;
+    }
+
+    bool ParseValue(V8_JsonValue& out, uint32_t depth) {
+      if (depth > maxDepth)
+        return Fail("document nested too deeply");
+
+      SkipWhitespace();
+      if (pos >= text.size())
+        return Fail("unexpected end of document");
+
+      char c = text[pos];
+
+      if (c == '{') {
+        out.type = V8_JsonValue::Type::Object;
+        pos++;
+        SkipWhitespace();
+
+        if (pos < text.size() && text[pos] == '}') {
+          pos++;
+          return true;
+        }
+
+        while (true) {
+          SkipWhitespace();
+          if (pos >= text.size() || text[pos] != '"')
+            return Fail("expected object key");
+
+          auto& member = out.object.emplace_back();
+          if (!ParseString(member.first))
+            return false;
+
+          SkipWhitespace();
+          if (!Consume(":"))
+            return Fail("expected ':'");
+
+          if (!ParseValue(member.second, depth + 1))
+            return false;
+
+          SkipWhitespace();
+          if (Consume(","))
+            continue;
+          if (Consume("}"))
+            return true;
+
+          return Fail("expected ',' or '}'");
+        }
+      }
+
+      if (c == '[') {
+        out.type = V8_JsonValue::Type::Array;
+        pos++;
+        SkipWhitespace();
+
+        if (pos < text.size() && text[pos] == ']') {
+          pos++;
+          return true;
+        }
+
+        while (true) {
+          if (!ParseValue(out.array.emplace_back(), depth + 1))
+            return false;
+
+          SkipWhitespace();
+          if (Consume(","))
+            continue;
+          if (Consume("]"))
+            return true;
+
+          return Fail("expected ',' or ']'");
+        }
+      }
+
+      if (c == '"') {
+        out.type = V8_JsonValue::Type::String;
+        return ParseString(out.string);
+      }
+
+      if (Consume("true")) {
+        out.type = V8_JsonValue::Type::Bool;
+        out.boolean = true;
+        return true;
+      }
+
+      if (Consume("false")) {
+        out.type = V8_JsonValue::Type::Bool;
+        out.boolean = false;
+        return true;
+      }
+
+      if (Consume("null")) {
+        out.type = V8_JsonValue::Type::Null;
+        return true;
+      }
+
+      return ParseNumber(out);
+    }
+  };
+}
+
+const V8_JsonValue& V8_JsonValue::operator[](std::string_view key) const {
+  if (type != Type::Object)
+    return nullValue;
+
+  for (const auto& [name, value] : object) {
+    if (name == key)
+      return value;
+  }
+
+  return nullValue;
+}
+
+const V8_JsonValue& V8_JsonValue::operator[](size_t index) const {
+  if (type != Type::Array || index >= array.size())
+    return nullValue;
+
+  return array[index];
+}
+
+bool V8_ParseJson(std::string_view text, V8_JsonValue& out, std::string* error) {
+  Parser parser;
+  parser.text = text;
+  out = V8_JsonValue {};
+
+  bool ok = parser.ParseValue(out, 0);
+  if (ok) {
+    parser.SkipWhitespace();
+    if (parser.pos != text.size())
+      ok = parser.Fail("trailing characters after document");
+  }
+
+  if (!ok && error)
+    *error = parser.error;
+
+  return ok;
+}
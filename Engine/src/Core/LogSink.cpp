@@ -0,0 +1,160 @@
+#include <Core/LogSink.h>
+
+namespace {
+  const char* LevelTag(V8_Logger::LogLevel level) {
+    switch (level) {
+      case V8_Logger::LogLevel::Debug: return "[DEBUG] ";
+      case V8_Logger::LogLevel::Info: return "[INFO] ";
+      case V8_Logger::LogLevel::Warning: return "[WARNING] ";
+      case V8_Logger::LogLevel::Error: return "[ERROR] ";
+      case V8_Logger::LogLevel::Fatal: return "[FATAL] ";
+    }
+
+    return "[?] ";
+  }
+
+  const char* LevelColor(V8_Logger::LogLevel level) {
+    switch (level) {
+      case V8_Logger::LogLevel::Debug: return "\033[36m";
+      case V8_Logger::LogLevel::Info: return "\033[34m";
+      case V8_Logger::LogLevel::Warning: return "\033[33m";
+      case V8_Logger::LogLevel::Error: return "\033[35m";
+      case V8_Logger::LogLevel::Fatal: return "\033[31m";
+    }
+
+    return "";
+  }
+
+  void AppendLine(std::string& out, const V8_LogRecord& record, bool color) {
+    if (color)
+      out += LevelColor(record.level);
+
+    out += LevelTag(record.level);
+    out += record.message;
+    if (record.truncated)
+      out += "...";
+
+    if (color)
+      out += "\033[0m";
+
+    out += " (from: ";
+    out += record.funcName;
+    out += ")\n";
+  }
+}
+
+void V8_ConsoleSink::Append(const V8_LogRecord& record) {
+  AppendLine(buffer_, record, color_);
+}
+
+void V8_ConsoleSink::EndBatch() {
+  out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  buffer_.clear();
+}
+
+void V8_ConsoleSink::Flush() {
+  out_->flush();
+}
+
+V8_RotatingFileSink::V8_RotatingFileSink(const std::filesystem::path& path, uint64_t maxBytes, uint32_t maxFiles) : path_(path), maxBytes_(maxBytes), maxFiles_(maxFiles) {
+  file_.open(path_, std::ios::binary | std::ios::app);
+
+  std::error_code error;
+  uint64_t size = std::filesystem::file_size(path_, error);
+  size_ = error ? 0 : size;
+}
+
+void V8_RotatingFileSink::Rotate() {
+  file_.close();
+
+  std::error_code error;
+  auto numbered = [&](uint32_t index) {
+    std::filesystem::path rotated = path_;
+    rotated += "." + std::to_string(index);
+    return rotated;
+  };
+
+  if (maxFiles_ > 1) {
+    std::filesystem::remove(numbered(maxFiles_ - 1), error);
+    for (uint32_t i = maxFiles_ - 1; i > 1; i--)
+      std::filesystem::rename(numbered(i - 1), numbered(i), error);
+
+    std::filesystem::rename(path_, numbered(1), error);
+  }
+
+  file_.open(path_, std::ios::binary | std::ios::trunc);
+  size_ = 0;
+}
+
+void V8_RotatingFileSink::Append(const V8_LogRecord& record) {
+  AppendLine(buffer_, record, false);
+}
+
+void V8_RotatingFileSink::EndBatch() {
+  // Batches aren't split, a file may overshoot maxBytes by one batch
+  if (size_ > 0 && size_ + buffer_.size() > maxBytes_)
+    Rotate();
+
+  if (file_.is_open()) {
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    size_ += buffer_.size();
+  }
+
+  buffer_.clear();
+}
+
+void V8_RotatingFileSink::Flush() {
+  file_.flush();
+}
+
+V8_RingSink::V8_RingSink(size_t capacity) : ring_(std::max<size_t>(capacity, 1)) {}
+
+void V8_RingSink::Append(const V8_LogRecord& record) {
+  AppendLine(buffer_, record, false);
+}
+
+void V8_RingSink::EndBatch() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::string_view batch = buffer_;
+  if (batch.size() > ring_.size())
+    batch = batch.substr(batch.size() - ring_.size());
+
+  while (!batch.empty()) {
+    size_t count = std::min(batch.size(), ring_.size() - head_);
+    std::memcpy(ring_.data() + head_, batch.data(), count);
+    batch.remove_prefix(count);
+
+    head_ += count;
+    if (head_ == ring_.size()) {
+      head_ = 0;
+      wrapped_ = true;
+    }
+  }
+
+  buffer_.clear();
+}
+
+std::string V8_RingSink::Contents() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!wrapped_)
+    return std::string(ring_.data(), head_);
+
+  std::string contents;
+  contents.reserve(ring_.size());
+  contents.append(ring_.data() + head_, ring_.size() - head_);
+  contents.append(ring_.data(), head_);
+
+  // The oldest line was partly overwritten
+  size_t newline = contents.find('\n');
+  contents.erase(0, newline == std::string::npos ? 0 : newline + 1);
+
+  return contents;
+}
+
+void V8_RingSink::Dump(std::ostream& out) const {
+  std::string contents = Contents();
+  out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  out.flush();
+}
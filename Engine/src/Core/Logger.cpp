@@ -1,60 +1,496 @@
 #include <Core/Logger.h>
+#include <Core/MemoryTracker.h>
+#include <Core/LogSink.h>
+
+#include <fmt/format.h>
+#include <fmt/args.h>
+#include <chrono>
+
+namespace {
+  constexpr uint64_t queueMask = V8_LOG_QUEUE_CAPACITY - 1;
+
+  // Spins before the consumer parks, so bursts don't pay for a wakeup
+  constexpr int consumerSpins = 64;
+
+  // Backstop for a missed wakeup; producers only notify a parked consumer
+  constexpr auto consumerSleep = std::chrono::milliseconds(50);
+}
+
+V8_Logger::V8_Logger(std::ostream* out) : slots_(new Slot[V8_LOG_QUEUE_CAPACITY]), isRunning_(true), sites_(new Site[V8_LOG_MAX_SITES]) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Logger);
+
+  sinks_.push_back(std::make_shared<V8_ConsoleSink>(out));
+
+  std::fill(std::begin(categoryLevels_), std::end(categoryLevels_), LogLevel::Debug);
+  UpdateFilter();
+
+  for (uint64_t i = 0; i < V8_LOG_QUEUE_CAPACITY; i++)
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
 
-V8_Logger::V8_Logger(std::ostream* out) : output_(out), isRunning_(true) {
   logThread_ = std::thread(&V8_Logger::ProcessQueue, this);
 }
 
 V8_Logger::~V8_Logger() {
   {
-    std::lock_guard<std::mutex> lock(logMutex_);
+    std::lock_guard<std::mutex> lock(wakeMutex_);
     isRunning_ = false;
   }
 
-  logCondition_.notify_one();
+  wakeCondition_.notify_one();
   if (logThread_.joinable())
     logThread_.join();
+
+  Flush();
 }
 
-void V8_Logger::ProcessQueue() {
+void V8_Logger::UpdateFilter() {
+  for (int level = V8_LOG_LEVEL_DEBUG; level <= V8_LOG_LEVEL_FATAL; level++) {
+    uint32_t mask = 0;
+    for (uint32_t bit = 0; bit < 32; bit++) {
+      if (level >= static_cast<int>(categoryLevels_[bit]))
+        mask |= 1u << bit;
+    }
+
+    levelMasks_[level].store(mask & categoryMask_, std::memory_order_relaxed);
+  }
+}
+
+void V8_Logger::SetLevel(LogLevel level) {
+  std::lock_guard<std::mutex> lock(filterMutex_);
+  std::fill(std::begin(categoryLevels_), std::end(categoryLevels_), level);
+  UpdateFilter();
+}
+
+void V8_Logger::SetLevel(V8_LogCategory category, LogLevel level) {
+  std::lock_guard<std::mutex> lock(filterMutex_);
+  for (uint32_t bit = 0; bit < 32; bit++) {
+    if (static_cast<uint32_t>(category) & (1u << bit))
+      categoryLevels_[bit] = level;
+  }
+
+  UpdateFilter();
+}
+
+void V8_Logger::SetCategoryMask(uint32_t mask) {
+  std::lock_guard<std::mutex> lock(filterMutex_);
+  categoryMask_ = mask;
+  UpdateFilter();
+}
+
+void V8_Logger::SetOutput(std::ostream* out) {
+  std::lock_guard<std::mutex> lock(outputMutex_);
+  sinks_.clear();
+  sinks_.push_back(std::make_shared<V8_ConsoleSink>(out));
+}
+
+void V8_Logger::AddSink(std::shared_ptr<V8_LogSink> sink) {
+  std::lock_guard<std::mutex> lock(outputMutex_);
+  sinks_.push_back(std::move(sink));
+}
+
+void V8_Logger::RemoveSink(const std::shared_ptr<V8_LogSink>& sink) {
+  std::lock_guard<std::mutex> lock(outputMutex_);
+  sink->Flush();
+  std::erase(sinks_, sink);
+}
+
+void V8_Logger::Flush() {
+  std::lock_guard<std::mutex> lock(outputMutex_);
+
+  bool urgent = false;
+  DrainLocked(urgent);
+  FlushLocked();
+}
+
+void V8_Logger::Fatal(std::string_view funcName, std::string_view message) {
+  {
+    std::lock_guard<std::mutex> lock(outputMutex_);
+
+    // Whatever led up to the fatal error is written first
+    bool urgent = false;
+    DrainLocked(urgent);
+
+    if (binaryLog_.is_open())
+      WriteBinary(0, LogLevel::Fatal, false, message, funcName);
+
+    WriteRepeatsLocked();
+
+    V8_LogRecord record { LogLevel::Fatal, message, false, funcName };
+    for (auto& sink : sinks_) {
+      sink->Append(record);
+      sink->EndBatch();
+    }
+
+    FlushLocked();
+    isRunning_ = false;
+  }
+
+  std::terminate();
+}
+
+uint32_t V8_Logger::RegisterSite(LogLevel level, std::string_view format, std::string_view funcName) {
+  std::lock_guard<std::mutex> lock(siteMutex_);
+
+  uint32_t count = siteCount_.load(std::memory_order_relaxed);
+  if (count == V8_LOG_MAX_SITES)
+    return 0;
+
+  sites_[count] = { level, format, funcName };
+  siteCount_.store(count + 1, std::memory_order_release);
+
+  return count + 1;
+}
+
+bool V8_Logger::FormatDeferred(std::string& out, std::string_view format, const char* payload, uint32_t size) {
+  // Kept per thread so formatting stops allocating once the store has grown to the widest message
+  thread_local fmt::dynamic_format_arg_store<fmt::format_context> args;
+  args.clear();
+  uint32_t offset = 0;
+
+  auto read = [&](auto& value) {
+    if (offset + sizeof(value) > size)
+      return false;
+
+    std::memcpy(&value, payload + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+  };
+
+  while (offset < size) {
+    V8_LogArgType type = static_cast<V8_LogArgType>(payload[offset++]);
+
+    switch (type) {
+      case V8_LogArgType::Bool: { uint8_t v; if (!read(v)) return false; args.push_back(v != 0); break; }
+      case V8_LogArgType::Char: { char v; if (!read(v)) return false; args.push_back(v); break; }
+      case V8_LogArgType::Int: { int64_t v; if (!read(v)) return false; args.push_back(v); break; }
+      case V8_LogArgType::UInt: { uint64_t v; if (!read(v)) return false; args.push_back(v); break; }
+      case V8_LogArgType::Double: { double v; if (!read(v)) return false; args.push_back(v); break; }
+      case V8_LogArgType::Float: { float v; if (!read(v)) return false; args.push_back(v); break; }
+      case V8_LogArgType::Pointer: { uint64_t v; if (!read(v)) return false; args.push_back(reinterpret_cast<const void*>(v)); break; }
+      case V8_LogArgType::String: {
+        uint32_t length;
+        if (!read(length) || offset + length > size)
+          return false;
+
+        // The payload outlives the format call, views avoid copying into the store
+        args.push_back(fmt::string_view(payload + offset, length));
+        offset += length;
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+
+  out.clear();
+
+  try {
+    fmt::vformat_to(std::back_inserter(out), fmt::string_view(format.data(), format.size()), args);
+  } catch (const fmt::format_error&) {
+    // A truncated payload is missing trailing arguments
+    out.assign(format);
+    return false;
+  }
+
+  return true;
+}
+
+bool V8_Logger::OpenBinaryLog(const std::string& path) {
+  std::lock_guard<std::mutex> lock(outputMutex_);
+
+  binaryLog_.close();
+  binaryLog_.open(path, std::ios::binary | std::ios::trunc);
+  binarySitesWritten_ = 0;
+
+  if (!binaryLog_.is_open())
+    return false;
+
+  uint32_t header[2] = { V8_BINARY_LOG_MAGIC, V8_BINARY_LOG_VERSION };
+  binaryLog_.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+  return binaryLog_.good();
+}
+
+void V8_Logger::CloseBinaryLog() {
+  std::lock_guard<std::mutex> lock(outputMutex_);
+  binaryLog_.close();
+}
+
+void V8_Logger::WriteBinary(uint32_t site, LogLevel level, bool truncated, std::string_view payload, std::string_view funcName) {
+  auto write = [this](const auto& value) {
+    binaryLog_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+
+  auto writeString = [&](std::string_view value) {
+    write(static_cast<uint32_t>(value.size()));
+    binaryLog_.write(value.data(), value.size());
+  };
+
+  // Sites are defined in the file the first time a record could reference them
+  uint32_t siteCount = siteCount_.load(std::memory_order_acquire);
+  for (; binarySitesWritten_ < siteCount; binarySitesWritten_++) {
+    const Site& site = sites_[binarySitesWritten_];
+    write(V8_BinaryLogRecord::Site);
+    write(binarySitesWritten_ + 1);
+    write(static_cast<uint8_t>(site.level));
+    writeString(site.format);
+    writeString(site.funcName);
+  }
+
+  write(V8_BinaryLogRecord::Message);
+  write(site);
+  write(static_cast<uint8_t>(level));
+  write(static_cast<uint8_t>(truncated));
+  writeString(payload);
+
+  if (site == 0)
+    writeString(funcName);
+}
+
+V8_Logger::Slot* V8_Logger::AcquireSlot(uint64_t& pos) {
+  pos = enqueuePos_.load(std::memory_order_relaxed);
+
   while (true) {
-    std::unique_lock<std::mutex> lock(logMutex_);
-    logCondition_.wait(lock, [this] { return !logQueue_.empty() || !isRunning_; });
-
-    while (!logQueue_.empty()) {
-      std::tuple<std::string, std::string, LogLevel> log = logQueue_.front();
-      std::string message = std::get<0>(log);
-      std::string funcName = std::get<1>(log);
-      LogLevel level = std::get<2>(log);
-
-      switch (level) {
-        case LogLevel::Debug:
-          message = "[DEBUG] " + message;
-          (*output_) << "\033[36m" << message << "\033[0m" << " (from: " << funcName << ")" << std::endl;
-          break;
-        case LogLevel::Info:
-          message = "[INFO] " + message;
-          (*output_) << "\033[34m" << message << "\033[0m" << " (from: " << funcName << ")" << std::endl;
-          break;
-        case LogLevel::Warning:
-          message = "[WARNING] " + message;
-          (*output_) << "\033[33m" << message << "\033[0m" << " (from: " << funcName << ")" << std::endl;
-          break;
-        case LogLevel::Error:
-          message = "[ERROR] " + message;
-          (*output_) << "\033[35m" << message << "\033[0m" << " (from: " << funcName << ")" << std::endl;
+    Slot& slot = slots_[pos & queueMask];
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+
+    if (diff == 0) {
+      if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        return &slot;
+    } else if (diff < 0) {
+      // Full: the slot still holds the message from one lap ago
+      switch (backpressure_.load(std::memory_order_relaxed)) {
+        case Backpressure::Drop:
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return nullptr;
+
+        case Backpressure::Block:
+          if (consumerSleeping_.load(std::memory_order_relaxed))
+            wakeCondition_.notify_one();
+          std::this_thread::yield();
           break;
-        case LogLevel::Fatal:
-          message = "[FATAL] " + message;
-          (*output_) << "\033[31m" << message << "\033[0m" << " (from: " << funcName << ")" << std::endl;
-          exit(1);
+
+        case Backpressure::Overwrite: {
+          // Only the message in our way is discarded, if the consumer is already writing it out we wait
+          uint64_t oldest;
+          if (dequeuePos_.load(std::memory_order_relaxed) + V8_LOG_QUEUE_CAPACITY > pos)
+            std::this_thread::yield();
+          else if (Slot* victim = TryDequeue(oldest)) {
+            ReleaseSlot(victim, oldest);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+          }
           break;
+        }
       }
 
-      logQueue_.pop();
+      pos = enqueuePos_.load(std::memory_order_relaxed);
+    } else {
+      pos = enqueuePos_.load(std::memory_order_relaxed);
     }
+  }
+}
+
+void V8_Logger::PublishSlot(Slot* slot, uint64_t pos) {
+  slot->sequence.store(pos + 1, std::memory_order_release);
+
+  // Pairs with the fence in ProcessQueue: either the consumer sees this slot
+  // before parking, or we see it parked and wake it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumerSleeping_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    wakeCondition_.notify_one();
+  }
+}
+
+// Dequeue is CAS based rather than consumer-only so producers can discard under Backpressure::Overwrite
+V8_Logger::Slot* V8_Logger::TryDequeue(uint64_t& pos) {
+  pos = dequeuePos_.load(std::memory_order_relaxed);
+
+  while (true) {
+    Slot& slot = slots_[pos & queueMask];
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1);
+
+    if (diff == 0) {
+      if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        return &slot;
+    } else if (diff < 0) {
+      return nullptr;
+    } else {
+      pos = dequeuePos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void V8_Logger::ReleaseSlot(Slot* slot, uint64_t pos) {
+  slot->sequence.store(pos + V8_LOG_QUEUE_CAPACITY, std::memory_order_release);
+}
+
+size_t V8_Logger::DrainLocked(bool& urgent) {
+  size_t count = 0;
 
-    if (!isRunning_) 
+  // Bounded so producers that keep up with the consumer can't hold a batch open forever
+  while (count < V8_LOG_QUEUE_CAPACITY) {
+    uint64_t pos;
+    Slot* slot = TryDequeue(pos);
+    if (slot == nullptr)
       break;
+
+    count++;
+    urgent |= slot->level >= LogLevel::Error;
+
+    std::string_view message(slot->message, slot->length);
+
+    if (binaryLog_.is_open()) {
+      WriteBinary(slot->site, slot->level, slot->truncated, message, slot->funcName);
+
+      // Deferred records are left for the decoder, only preformatted text is echoed
+      if (slot->site != 0) {
+        ReleaseSlot(slot, pos);
+        continue;
+      }
+    }
+
+    if (slot->site != 0) {
+      FormatDeferred(formatBuffer_, sites_[slot->site - 1].format, slot->message, slot->length);
+      message = formatBuffer_;
+    }
+
+    // Sinks copy the record into their batch buffers, so the slot can go back right after
+    WriteRecordLocked(slot->level, message, slot->truncated, slot->funcName);
+
+    ReleaseSlot(slot, pos);
+  }
+
+  uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != reportedDrops_) {
+    formatBuffer_.clear();
+    fmt::format_to(std::back_inserter(formatBuffer_), "{} log messages dropped, queue full", dropped - reportedDrops_);
+    reportedDrops_ = dropped;
+
+    WriteRecordLocked(LogLevel::Warning, formatBuffer_, false, "V8_Logger");
+
+    count++;
+  }
+
+  if (count > 0) {
+    for (auto& sink : sinks_)
+      sink->EndBatch();
+
+    dirty_ = true;
+  }
+
+  return count;
+}
+
+void V8_Logger::WriteRecordLocked(LogLevel level, std::string_view message, bool truncated, std::string_view funcName) {
+  if (level == lastLevel_ && truncated == lastTruncated_ && funcName == lastFuncName_ && message == lastMessage_) {
+    repeats_++;
+    return;
+  }
+
+  WriteRepeatsLocked();
+
+  V8_LogRecord record { level, message, truncated, funcName };
+  for (auto& sink : sinks_)
+    sink->Append(record);
+
+  lastMessage_.assign(message);
+  lastFuncName_ = funcName;
+  lastLevel_ = level;
+  lastTruncated_ = truncated;
+}
+
+void V8_Logger::WriteRepeatsLocked() {
+  if (repeats_ == 0)
+    return;
+
+  char text[64];
+  auto result = fmt::format_to_n(text, sizeof(text), "last message repeated {} times", repeats_);
+  repeats_ = 0;
+
+  V8_LogRecord record { lastLevel_, std::string_view(text, std::min(result.size, sizeof(text))), false, lastFuncName_ };
+  for (auto& sink : sinks_)
+    sink->Append(record);
+}
+
+void V8_Logger::FlushLocked() {
+  // A run of repeats is summarized at least once per flush so it isn't held back indefinitely
+  if (repeats_ > 0) {
+    WriteRepeatsLocked();
+    for (auto& sink : sinks_)
+      sink->EndBatch();
+  }
+
+  for (auto& sink : sinks_)
+    sink->Flush();
+
+  if (binaryLog_.is_open())
+    binaryLog_.flush();
+
+  dirty_ = false;
+}
+
+void V8_Logger::ProcessQueue() {
+  V_MEMORY_SCOPE(V8_MemoryTag::Logger);
+
+  auto lastFlush = std::chrono::steady_clock::now();
+  int idleSpins = 0;
+
+  while (true) {
+    size_t count;
+    bool dirty;
+
+    {
+      std::lock_guard<std::mutex> lock(outputMutex_);
+
+      bool urgent = false;
+      count = DrainLocked(urgent);
+
+      auto now = std::chrono::steady_clock::now();
+      auto interval = std::chrono::milliseconds(flushIntervalMs_.load(std::memory_order_relaxed));
+      if (dirty_ && (urgent || now - lastFlush >= interval)) {
+        FlushLocked();
+        lastFlush = now;
+      }
+
+      dirty = dirty_;
+    }
+
+    if (count > 0) {
+      idleSpins = 0;
+      continue;
+    }
+
+    if (!isRunning_)
+      break;
+
+    if (++idleSpins < consumerSpins) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    idleSpins = 0;
+
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    consumerSleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint64_t next = dequeuePos_.load(std::memory_order_relaxed);
+    bool empty = slots_[next & queueMask].sequence.load(std::memory_order_acquire) != next + 1;
+    if (empty && isRunning_) {
+      // Wake up in time for a pending periodic flush
+      auto sleep = consumerSleep;
+      if (dirty) {
+        auto remaining = std::chrono::milliseconds(flushIntervalMs_.load(std::memory_order_relaxed)) - std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastFlush);
+        sleep = std::clamp(remaining, std::chrono::milliseconds(1), consumerSleep);
+      }
+
+      wakeCondition_.wait_for(lock, sleep);
+    }
+
+    consumerSleeping_.store(false, std::memory_order_relaxed);
   }
 }
 
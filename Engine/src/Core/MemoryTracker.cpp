@@ -0,0 +1,227 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Core
+
+#include <Core/MemoryTracker.h>
+#include <Core/Logger.h>
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+V8_MemoryTracker memoryTracker;
+
+namespace {
+  thread_local V8_MemoryTag currentTag = V8_MemoryTag::General;
+
+  constexpr const char* tagNames[] = { "General", "ECS", "Renderer", "Logger", "Assets", "Driver" };
+  static_assert(std::size(tagNames) == static_cast<size_t>(V8_MemoryTag::Count));
+}
+
+const char* V8_MemoryTracker::TagName(V8_MemoryTag tag) {
+  return tagNames[static_cast<size_t>(tag)];
+}
+
+void V8_MemoryTracker::OnAllocate(V8_MemoryTag tag, size_t size) {
+  Counters& counters = counters_[static_cast<size_t>(tag)];
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void V8_MemoryTracker::OnFree(V8_MemoryTag tag, size_t size) {
+  Counters& counters = counters_[static_cast<size_t>(tag)];
+  counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+  counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+V8_MemoryStats V8_MemoryTracker::GetStats(V8_MemoryTag tag) const {
+  const Counters& counters = counters_[static_cast<size_t>(tag)];
+  return {
+    counters.liveBytes.load(std::memory_order_relaxed),
+    counters.peakBytes.load(std::memory_order_relaxed),
+    counters.allocations.load(std::memory_order_relaxed),
+    counters.liveAllocations.load(std::memory_order_relaxed)
+  };
+}
+
+void V8_MemoryTracker::Report() const {
+  if (!Enabled())
+    return;
+
+  V_REPORT("{:<10} {:>12} {:>12} {:>12} {:>12}", "Memory", "live KiB", "peak KiB", "live count", "total count");
+  for (size_t i = 0; i < counters_.size(); i++) {
+    V8_MemoryStats stats = GetStats(static_cast<V8_MemoryTag>(i));
+    V_REPORT("{:<10} {:>12.1f} {:>12.1f} {:>12} {:>12}", tagNames[i], stats.liveBytes / 1024.0, stats.peakBytes / 1024.0, stats.liveAllocations, stats.allocations);
+  }
+}
+
+void V8_MemoryTracker::ReportLeaks() const {
+  if (!Enabled())
+    return;
+
+  // Not through the logger, it has usually been destroyed by now
+  for (size_t i = 0; i < counters_.size(); i++) {
+    V8_MemoryStats stats = GetStats(static_cast<V8_MemoryTag>(i));
+    if (stats.liveAllocations != 0)
+      std::fprintf(stderr, "%s still holds %llu allocations (%llu bytes) at exit\n", tagNames[i], static_cast<unsigned long long>(stats.liveAllocations), static_cast<unsigned long long>(stats.liveBytes));
+  }
+}
+
+V8_MemoryScope::V8_MemoryScope(V8_MemoryTag tag) : previous_(currentTag) {
+  currentTag = tag;
+}
+
+V8_MemoryScope::~V8_MemoryScope() {
+  currentTag = previous_;
+}
+
+V8_MemoryTag V8_MemoryScope::Current() {
+  return currentTag;
+}
+
+#ifdef V8_MEMORY_TRACKING
+
+// Constructed before, and so destroyed after, every static object with default priority
+#ifdef _MSC_VER
+  #pragma init_seg(lib)
+  #define V8_INIT_EARLY
+#else
+  #define V8_INIT_EARLY __attribute__((init_priority(101)))
+#endif
+
+namespace {
+  struct ExitReport {
+    ~ExitReport() {
+      memoryTracker.ReportLeaks();
+    }
+  };
+
+  V8_INIT_EARLY ExitReport exitReport;
+
+  // Sits right before every tracked allocation, offset leads back to what malloc returned
+  struct alignas(16) Header {
+    uint64_t size;
+    uint32_t offset;
+    V8_MemoryTag tag;
+  };
+
+  void* TrackedAllocate(size_t size, size_t alignment, V8_MemoryTag tag) {
+    alignment = std::max(alignment, alignof(Header));
+    size_t padding = alignment > alignof(Header) ? alignment - alignof(Header) : 0;
+
+    std::byte* raw = static_cast<std::byte*>(std::malloc(size + sizeof(Header) + padding));
+    if (raw == nullptr)
+      return nullptr;
+
+    uintptr_t first = reinterpret_cast<uintptr_t>(raw) + sizeof(Header);
+    std::byte* pointer = raw + (((first + alignment - 1) & ~(alignment - 1)) - reinterpret_cast<uintptr_t>(raw));
+
+    Header* header = reinterpret_cast<Header*>(pointer) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(pointer - raw);
+    header->tag = tag;
+
+    memoryTracker.OnAllocate(tag, size);
+    return pointer;
+  }
+
+  void TrackedFree(void* pointer) {
+    if (pointer == nullptr)
+      return;
+
+    Header* header = static_cast<Header*>(pointer) - 1;
+    memoryTracker.OnFree(header->tag, header->size);
+    std::free(static_cast<std::byte*>(pointer) - header->offset);
+  }
+
+  void* NewOrThrow(size_t size, size_t alignment) {
+    void* pointer = TrackedAllocate(size, alignment, currentTag);
+    if (pointer == nullptr)
+      throw std::bad_alloc();
+    return pointer;
+  }
+
+  VKAPI_ATTR void* VKAPI_CALL VulkanAllocate(void*, size_t size, size_t alignment, VkSystemAllocationScope) {
+    return TrackedAllocate(size, alignment, V8_MemoryTag::Driver);
+  }
+
+  VKAPI_ATTR void* VKAPI_CALL VulkanReallocate(void*, void* original, size_t size, size_t alignment, VkSystemAllocationScope) {
+    if (original == nullptr)
+      return TrackedAllocate(size, alignment, V8_MemoryTag::Driver);
+
+    if (size == 0) {
+      TrackedFree(original);
+      return nullptr;
+    }
+
+    void* pointer = TrackedAllocate(size, alignment, V8_MemoryTag::Driver);
+    if (pointer == nullptr)
+      return nullptr;
+
+    std::memcpy(pointer, original, std::min<size_t>(size, (static_cast<Header*>(original) - 1)->size));
+    TrackedFree(original);
+    return pointer;
+  }
+
+  VKAPI_ATTR void VKAPI_CALL VulkanFree(void*, void* pointer) {
+    TrackedFree(pointer);
+  }
+
+  // Memory the driver allocates itself, such as executable code, it only tells us about
+  VKAPI_ATTR void VKAPI_CALL VulkanInternalAllocate(void*, size_t size, VkInternalAllocationType, VkSystemAllocationScope) {
+    memoryTracker.OnAllocate(V8_MemoryTag::Driver, size);
+  }
+
+  VKAPI_ATTR void VKAPI_CALL VulkanInternalFree(void*, size_t size, VkInternalAllocationType, VkSystemAllocationScope) {
+    memoryTracker.OnFree(V8_MemoryTag::Driver, size);
+  }
+
+  const VkAllocationCallbacks vulkanAllocator = {
+    nullptr,
+    VulkanAllocate,
+    VulkanReallocate,
+    VulkanFree,
+    VulkanInternalAllocate,
+    VulkanInternalFree
+  };
+}
+
+const VkAllocationCallbacks* V8_VulkanAllocator() {
+  return &vulkanAllocator;
+}
+
+void* operator new(size_t size) { return NewOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return NewOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return NewOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return NewOrThrow(size, static_cast<size_t>(alignment)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, currentTag); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, currentTag); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<size_t>(alignment), currentTag); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<size_t>(alignment), currentTag); }
+
+void operator delete(void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+
+#else
+
+const VkAllocationCallbacks* V8_VulkanAllocator() {
+  return nullptr;
+}
+
+#endif
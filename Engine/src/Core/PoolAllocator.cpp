@@ -0,0 +1,62 @@
+#include <Core/PoolAllocator.h>
+
+#include <cstdlib>
+#include <new>
+
+V8_PoolStorage::V8_PoolStorage(size_t size, size_t alignment, size_t nodesPerSlab)
+  : nodeSize_((size + alignment - 1) & ~(alignment - 1)), alignment_(alignment), nodesPerSlab_(nodesPerSlab) {}
+
+V8_PoolStorage::~V8_PoolStorage() {
+  while (slabs_ != nullptr) {
+    Slab* next = slabs_->next;
+    std::free(slabs_);
+    slabs_ = next;
+  }
+}
+
+void V8_PoolStorage::AddSlab() {
+  // Straight from malloc, the memory tracker counts the objects handed out rather than the slabs behind them
+  size_t slabSize = sizeof(Slab) + alignment_ + nodeSize_ * nodesPerSlab_;
+  Slab* slab = static_cast<Slab*>(std::malloc(slabSize));
+  if (slab == nullptr)
+    throw std::bad_alloc();
+
+  slab->next = slabs_;
+  slabs_ = slab;
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(slab + 1);
+  std::byte* first = reinterpret_cast<std::byte*>(slab + 1) + (((base + alignment_ - 1) & ~(alignment_ - 1)) - base);
+
+  // Linked back to front so nodes are handed out in address order
+  for (size_t i = nodesPerSlab_; i-- > 0;) {
+    Node* node = reinterpret_cast<Node*>(first + i * nodeSize_);
+    node->next = free_;
+    free_ = node;
+  }
+}
+
+V8_PoolStorage::Node* V8_PoolStorage::AllocateBatch(uint32_t& count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (free_ == nullptr)
+    AddSlab();
+
+  Node* head = free_;
+  Node* tail = head;
+  uint32_t taken = 1;
+  while (taken < count && tail->next != nullptr) {
+    tail = tail->next;
+    taken++;
+  }
+
+  free_ = tail->next;
+  tail->next = nullptr;
+  count = taken;
+  return head;
+}
+
+void V8_PoolStorage::FreeBatch(Node* head, Node* tail) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tail->next = free_;
+  free_ = head;
+}
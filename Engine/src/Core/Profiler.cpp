@@ -0,0 +1,198 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Core
+
+#include <Core/Profiler.h>
+
+#include <fmt/format.h>
+#include <fstream>
+
+namespace {
+  void AppendEscaped(std::string& out, std::string_view text) {
+    for (char c : text) {
+      if (c == '"' || c == '\\')
+        out += '\\';
+
+      if (static_cast<unsigned char>(c) < 0x20)
+        continue;
+
+      out += c;
+    }
+  }
+}
+
+V8_Profiler::V8_Profiler() : origin_(Now()) {}
+
+V8_Profiler::LocalState::~LocalState() {
+  if (buffer != nullptr)
+    profiler.ReleaseTrack(buffer->id);
+}
+
+V8_Profiler::LocalState& V8_Profiler::Local() {
+  static thread_local LocalState local;
+  return local;
+}
+
+V8_Profiler::ThreadBuffer* V8_Profiler::LocalBuffer() {
+  LocalState& local = Local();
+  if (local.buffer == nullptr)
+    local.buffer = CreateBuffer(local.name);
+  return local.buffer;
+}
+
+V8_Profiler::ThreadBuffer* V8_Profiler::CreateBuffer(std::string_view name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Pools rebuilt per job would otherwise add a buffer for every worker they ever started.
+  // One left under the same name keeps the trace readable, so it goes first.
+  ThreadBuffer* buffer = nullptr;
+  for (const auto& candidate : threads_) {
+    if (!candidate->retired)
+      continue;
+
+    if (buffer == nullptr || candidate->name == name)
+      buffer = candidate.get();
+    if (candidate->name == name)
+      break;
+  }
+
+  if (buffer == nullptr) {
+    buffer = threads_.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    buffer->id = static_cast<uint32_t>(threads_.size());
+    buffer->generation.store(generation_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  buffer->retired = false;
+  buffer->name = name.empty() ? "Thread " + std::to_string(buffer->id) : std::string(name);
+  return buffer;
+}
+
+uint32_t V8_Profiler::CreateTrack(std::string_view name) {
+  return CreateBuffer(name)->id;
+}
+
+void V8_Profiler::RecordOnTrack(uint32_t track, std::string_view name, uint64_t start, uint64_t end) {
+  ThreadBuffer* buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (track == 0 || track > threads_.size() || threads_[track - 1]->retired)
+      return;
+
+    buffer = threads_[track - 1].get();
+  }
+
+  Append(buffer, name, start, end);
+}
+
+void V8_Profiler::ReleaseTrack(uint32_t track) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (track != 0 && track <= threads_.size())
+    threads_[track - 1]->retired = true;
+}
+
+void V8_Profiler::SetThreadName(std::string_view name) {
+  LocalState& local = Local();
+  local.name = name;
+
+  if (local.buffer == nullptr)
+    return;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  local.buffer->name = name;
+}
+
+void V8_Profiler::Record(std::string_view name, uint64_t start, uint64_t end) {
+  Append(LocalBuffer(), name, start, end);
+}
+
+void V8_Profiler::Append(ThreadBuffer* buffer, std::string_view name, uint64_t start, uint64_t end) {
+  uint32_t generation = generation_.load(std::memory_order_acquire);
+  if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->generation.store(generation, std::memory_order_release);
+  }
+
+  // Set before the first count is published, WriteChromeTrace skips empty buffers
+  if (buffer->events == nullptr)
+    buffer->events.reset(new V8_ProfileEvent[V8_PROFILE_EVENTS_PER_THREAD]);
+
+  uint32_t count = buffer->count.load(std::memory_order_relaxed);
+  if (count == V8_PROFILE_EVENTS_PER_THREAD) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  buffer->events[count] = { name, start, end };
+  buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void V8_Profiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  generation_.fetch_add(1, std::memory_order_release);
+  dropped_.store(0, std::memory_order_relaxed);
+  origin_ = Now();
+}
+
+bool V8_Profiler::WriteChromeTrace(const std::string& path) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    V_ERROR("Failed to open {} for the profiler trace", path);
+    return false;
+  }
+
+  // Clear takes the same lock, so no buffer is reset while it's being read
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint32_t generation = generation_.load(std::memory_order_acquire);
+
+  std::string out;
+  out.reserve(1 << 20);
+  out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool first = true;
+  auto separator = [&]() {
+    if (!first)
+      out += ",\n";
+    first = false;
+  };
+
+  for (const auto& buffer : threads_) {
+    separator();
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,";
+    fmt::format_to(std::back_inserter(out), "\"tid\":{},\"args\":{{\"name\":\"", buffer->id);
+    AppendEscaped(out, buffer->name);
+    out += "\"}}";
+
+    if (buffer->generation.load(std::memory_order_acquire) != generation)
+      continue;
+
+    uint32_t count = buffer->count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+      const V8_ProfileEvent& event = buffer->events[i];
+
+      // Zones still open at Clear started before the new origin
+      if (event.start < origin_)
+        continue;
+
+      separator();
+      out += "{\"name\":\"";
+      AppendEscaped(out, event.name);
+      fmt::format_to(std::back_inserter(out), "\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+        buffer->id, (event.start - origin_) / 1000.0, (event.end - event.start) / 1000.0);
+    }
+
+    if (out.size() > (1 << 20)) {
+      file.write(out.data(), static_cast<std::streamsize>(out.size()));
+      out.clear();
+    }
+  }
+
+  out += "]}\n";
+  file.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+  uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped > 0)
+    V_WARNING("Profiler buffers were full, {} zones are missing from {}", dropped, path);
+
+  return file.good();
+}
+
+V8_Profiler profiler;
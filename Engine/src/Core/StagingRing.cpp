@@ -0,0 +1,217 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Core
+
+#include <Core/MemoryTracker.h>
+#include <Core/StagingRing.h>
+#include <Core/Utils.h>
+#include <Core/Profiler.h>
+
+#include <algorithm>
+#include <cstring>
+
+void V8_StagingRing::Init(VkDevice device, VmaAllocator allocator, VkQueue queue, VkCommandPool commandPool, VkDeviceSize capacity) {
+  device_ = device;
+  allocator_ = allocator;
+  queue_ = queue;
+  commandPool_ = commandPool;
+  capacity_ = capacity;
+
+  VkBufferCreateInfo bufferInfo {};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = capacity_;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo {};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo allocationInfo {};
+  VK_CHECK(vmaCreateBuffer(allocator_, &bufferInfo, &allocInfo, &buffer_, &allocation_, &allocationInfo));
+
+  mapped_ = static_cast<uint8_t*>(allocationInfo.pMappedData);
+}
+
+void V8_StagingRing::Shutdown() {
+  if (buffer_ == VK_NULL_HANDLE)
+    return;
+
+  Flush();
+
+  for (auto& batch : freeBatches_) {
+    vkDestroyFence(device_, batch.fence, V8_VulkanAllocator());
+    vkFreeCommandBuffers(device_, commandPool_, 1, &batch.cmd);
+  }
+
+  freeBatches_.clear();
+
+  vmaDestroyBuffer(allocator_, buffer_, allocation_);
+  buffer_ = VK_NULL_HANDLE;
+  allocation_ = VK_NULL_HANDLE;
+  mapped_ = nullptr;
+}
+
+void V8_StagingRing::BeginBatch() {
+  if (freeBatches_.empty()) {
+    Batch batch;
+
+    VkCommandBufferAllocateInfo cmdBufferAllocInfo {};
+    cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmdBufferAllocInfo.commandPool = commandPool_;
+    cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdBufferAllocInfo.commandBufferCount = 1;
+
+    VK_CHECK(vkAllocateCommandBuffers(device_, &cmdBufferAllocInfo, &batch.cmd));
+
+    VkFenceCreateInfo fenceInfo {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    VK_CHECK(vkCreateFence(device_, &fenceInfo, V8_VulkanAllocator(), &batch.fence));
+
+    freeBatches_.push_back(batch);
+  }
+
+  current_ = freeBatches_.back();
+  freeBatches_.pop_back();
+  current_.bytes = 0;
+
+  VkCommandBufferBeginInfo cmdBufferBeginInfo {};
+  cmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+  VK_CHECK(vkResetCommandBuffer(current_.cmd, 0));
+  VK_CHECK(vkBeginCommandBuffer(current_.cmd, &cmdBufferBeginInfo));
+
+  recording_ = true;
+}
+
+void V8_StagingRing::Reclaim(bool waitOldest) {
+  if (waitOldest && !inFlight_.empty()) {
+    V_PROFILE_SCOPE("Staging ring stall");
+
+    uint64_t start = V8_Profiler::Now();
+    VK_CHECK(vkWaitForFences(device_, 1, &inFlight_.front().fence, VK_TRUE, UINT64_MAX));
+    stallNanoseconds_ += V8_Profiler::Now() - start;
+  }
+
+  while (!inFlight_.empty() && vkGetFenceStatus(device_, inFlight_.front().fence) == VK_SUCCESS) {
+    Batch batch = inFlight_.front();
+    inFlight_.pop_front();
+
+    used_ -= batch.bytes;
+    VK_CHECK(vkResetFences(device_, 1, &batch.fence));
+    freeBatches_.push_back(batch);
+  }
+}
+
+uint8_t* V8_StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset) {
+  if (size > capacity_)
+    V_FATAL("Staging allocation of {} bytes exceeds the ring capacity of {} bytes", size, capacity_);
+
+  Reclaim(false);
+
+  while (true) {
+    // Nothing outstanding, start over at the front instead of paying for a wrap
+    if (used_ == 0)
+      head_ = 0;
+
+    VkDeviceSize aligned = (head_ + alignment - 1) / alignment * alignment;
+    VkDeviceSize needed = aligned - head_ + size;
+
+    // Wrap around, wasting the tail end of the ring
+    if (aligned + size > capacity_) {
+      aligned = 0;
+      needed = capacity_ - head_ + size;
+    }
+
+    if (used_ + needed <= capacity_) {
+      offset = aligned;
+      head_ = aligned + size;
+      used_ += needed;
+
+      if (!recording_) BeginBatch();
+      current_.bytes += needed;
+
+      return mapped_ + offset;
+    }
+
+    // Out of space: everything recorded so far has to be in flight before we can wait on it
+    if (recording_) Submit();
+
+    if (inFlight_.empty())
+      V_FATAL("Staging ring exhausted with no uploads in flight");
+
+    Reclaim(true);
+  }
+}
+
+void V8_StagingRing::Copy(VkBuffer dst, VkDeviceSize dstOffset, VkDeviceSize srcOffset, VkDeviceSize size) {
+  if (!recording_) BeginBatch();
+
+  VkBufferCopy copyRegion {};
+  copyRegion.srcOffset = srcOffset;
+  copyRegion.dstOffset = dstOffset;
+  copyRegion.size = size;
+
+  vkCmdCopyBuffer(current_.cmd, buffer_, dst, 1, &copyRegion);
+
+  bytesUploaded_ += size;
+}
+
+void V8_StagingRing::Upload(VkBuffer dst, VkDeviceSize dstOffset, const void* src, VkDeviceSize size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(src);
+  VkDeviceSize maxChunk = std::max<VkDeviceSize>(capacity_ / 4, 1);
+
+  while (size > 0) {
+    VkDeviceSize chunk = std::min(size, maxChunk);
+
+    VkDeviceSize offset;
+    uint8_t* dstPtr = Allocate(chunk, 16, offset);
+    memcpy(dstPtr, bytes, chunk);
+    Copy(dst, dstOffset, offset, chunk);
+
+    bytes += chunk;
+    dstOffset += chunk;
+    size -= chunk;
+  }
+}
+
+void V8_StagingRing::Submit() {
+  if (!recording_)
+    return;
+
+  V_PROFILE_FUNCTION();
+
+  // Make the copies visible to every later submission that reads geometry or shader data
+  VkMemoryBarrier barrier {};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT;
+
+  vkCmdPipelineBarrier(current_.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+  VK_CHECK(vkEndCommandBuffer(current_.cmd));
+
+  // No-op on host-coherent memory
+  VK_CHECK(vmaFlushAllocation(allocator_, allocation_, 0, VK_WHOLE_SIZE));
+
+  VkSubmitInfo submitInfo {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &current_.cmd;
+
+  VK_CHECK(vkQueueSubmit(queue_, 1, &submitInfo, current_.fence));
+
+  inFlight_.push_back(current_);
+  recording_ = false;
+
+  submissions_++;
+}
+
+void V8_StagingRing::Flush() {
+  Submit();
+
+  while (!inFlight_.empty())
+    Reclaim(true);
+}
@@ -0,0 +1,65 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Core
+
+#include <Core/Startup.h>
+#include <Core/Profiler.h>
+#include <Core/Logger.h>
+
+#include <algorithm>
+
+V8_StartupTimeline startupTimeline;
+
+void V8_StartupTimeline::Begin() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  phases_.clear();
+  origin_ = V8_Profiler::Now();
+  last_ = origin_;
+}
+
+void V8_StartupTimeline::Mark(std::string_view name) {
+  uint64_t now = V8_Profiler::Now();
+  uint64_t start;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (origin_ == 0)
+      return;
+
+    start = last_;
+    last_ = now;
+    phases_.push_back({ name, start, now });
+  }
+
+  if (profiler.IsEnabled())
+    profiler.Record(name, start, now);
+}
+
+void V8_StartupTimeline::Record(std::string_view name, uint64_t start, uint64_t end) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (origin_ == 0)
+      return;
+
+    phases_.push_back({ name, start, end });
+  }
+
+  if (profiler.IsEnabled())
+    profiler.Record(name, start, end);
+}
+
+void V8_StartupTimeline::Report() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (origin_ == 0)
+    return;
+
+  // Worker phases are recorded when they finish, order everything by start so overlaps read naturally
+  std::stable_sort(phases_.begin(), phases_.end(), [](const V8_StartupPhase& a, const V8_StartupPhase& b) { return a.start < b.start; });
+
+  uint64_t end = origin_;
+  for (const auto& phase : phases_)
+    end = std::max(end, phase.end);
+
+  V_REPORT("Startup took {:.1f} ms", (end - origin_) / 1e6);
+  for (const auto& phase : phases_)
+    V_REPORT("  at {:8.1f} ms {:8.1f} ms  {}", (phase.start - origin_) / 1e6, (phase.end - phase.start) / 1e6, phase.name);
+
+  origin_ = 0;
+}
@@ -0,0 +1,69 @@
+#include <Core/ThreadPool.h>
+#include <Core/Profiler.h>
+
+#include <algorithm>
+
+V8_ThreadPool::V8_ThreadPool(uint32_t threadCount, std::string name) {
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  workers_.reserve(threadCount);
+  for (uint32_t i = 0; i < threadCount; i++)
+    workers_.emplace_back(&V8_ThreadPool::WorkerLoop, this, name);
+}
+
+V8_ThreadPool::~V8_ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+
+  taskCondition_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+void V8_ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+
+  taskCondition_.notify_one();
+}
+
+void V8_ThreadPool::WaitIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idleCondition_.wait(lock, [this] { return tasks_.empty() && activeTasks_ == 0; });
+}
+
+void V8_ThreadPool::WorkerLoop(std::string name) {
+  profiler.SetThreadName(name);
+
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      taskCondition_.wait(lock, [this] { return !tasks_.empty() || stopping_; });
+
+      if (stopping_ && tasks_.empty())
+        return;
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      activeTasks_++;
+    }
+
+    task();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      activeTasks_--;
+      if (tasks_.empty() && activeTasks_ == 0)
+        idleCondition_.notify_all();
+    }
+  }
+}
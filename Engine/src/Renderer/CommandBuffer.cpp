@@ -1,3 +1,5 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
 #include <Renderer/Utils.h>
 
 #include <Core/Logger.h>
@@ -1,3 +1,5 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Vulkan
+
 #include <Renderer/Config.h>
 #include <Core/Logger.h>
 
@@ -29,7 +31,15 @@ V8_RenderConfig defaultRenderConfig = {
   .appVersion = VK_MAKE_API_VERSION(0, 1, 0, 0),
   .engineName = "V8 Engine",
   .engineVersion = VK_MAKE_API_VERSION(0, 1, 0, 0),
-  .apiVersion = VK_API_VERSION_1_3
+  .apiVersion = VK_API_VERSION_1_3,
+  .lodErrorThreshold = 1.0f,
+#ifdef V8_CULL_SHADER_PATH
+  .meshletCullShaderPath = V8_CULL_SHADER_PATH,
+#else
+  .meshletCullShaderPath = nullptr,
+#endif
+  .gpuTimers = true,
+  .pipelineStatistics = true
 };
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
@@ -39,16 +49,16 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
     void* pUserData) {
   switch(messageSeverity) {
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-      V_DEBUG("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_DEBUG_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-      V_INFO("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_INFO_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-      V_WARNING("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_WARNING_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-      V_ERROR("VULKAN: {}", std::string(pCallbackData->pMessage));
+      V_ERROR_LIMITED("VULKAN: {}", pCallbackData->pMessage);
       break;
     default:
       break;
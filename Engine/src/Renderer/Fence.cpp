@@ -1,3 +1,5 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
 #include <Renderer/Utils.h>
 #include <Core/Logger.h>
 
@@ -8,13 +10,13 @@ void V8_Fence::Init(const V8_Context& context, bool signaled) {
   fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
   fenceInfo.flags = signaled ? VK_FENCE_CREATE_SIGNALED_BIT : 0;
 
-  if (vkCreateFence(device_, &fenceInfo, nullptr, &fence_) != VK_SUCCESS)
+  if (vkCreateFence(device_, &fenceInfo, V8_VulkanAllocator(), &fence_) != VK_SUCCESS)
     V_FATAL("Failed to create fence");
 }
 
 V8_Fence::~V8_Fence() {
   if (fence_ != VK_NULL_HANDLE) {
-    vkDestroyFence(device_, fence_, nullptr);
+    vkDestroyFence(device_, fence_, V8_VulkanAllocator());
     fence_ = VK_NULL_HANDLE;
   }
 }
@@ -0,0 +1,143 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
+#include <Renderer/GpuTimer.h>
+#include <Core/Profiler.h>
+#include <Core/Utils.h>
+
+#include <algorithm>
+
+V8_GpuTimer::~V8_GpuTimer() {
+  Shutdown();
+}
+
+void V8_GpuTimer::Init(V8_Context& context, uint32_t framesInFlight, uint32_t zonesPerFrame) {
+  device_ = context.device_;
+
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice_, &familyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice_, &familyCount, families.data());
+
+  uint32_t validBits = context.graphicsQueueFamilyIndex_ < familyCount ? families[context.graphicsQueueFamilyIndex_].timestampValidBits : 0;
+  if (validBits == 0) {
+    V_WARNING("Graphics queue does not support timestamps, GPU timings are disabled");
+    return;
+  }
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(context.physicalDevice_, &properties);
+
+  period_ = properties.limits.timestampPeriod;
+  validMask_ = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+  zonesPerFrame_ = zonesPerFrame;
+
+  VkQueryPoolCreateInfo poolInfo {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  poolInfo.queryCount = framesInFlight * zonesPerFrame * 2;
+
+  VK_CHECK(vkCreateQueryPool(device_, &poolInfo, V8_VulkanAllocator(), &pool_));
+
+  frames_.assign(framesInFlight, {});
+  timestamps_.resize(zonesPerFrame * 2);
+  profilerTrack_ = profiler.CreateTrack("GPU");
+}
+
+void V8_GpuTimer::Shutdown() {
+  if (pool_ != VK_NULL_HANDLE)
+    vkDestroyQueryPool(device_, pool_, V8_VulkanAllocator());
+
+  pool_ = VK_NULL_HANDLE;
+  frames_.clear();
+
+  if (profilerTrack_ != 0)
+    profiler.ReleaseTrack(profilerTrack_);
+  profilerTrack_ = 0;
+  results_.clear();
+}
+
+void V8_GpuTimer::Resolve(FrameQueries& frame) {
+  uint32_t queryCount = frame.written * 2;
+  uint32_t first = frame_ * zonesPerFrame_ * 2;
+
+  // The frame's fence has signaled, so this doesn't wait
+  VkResult res = vkGetQueryPoolResults(device_, pool_, first, queryCount, queryCount * sizeof(uint64_t), timestamps_.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+  if (res != VK_SUCCESS)
+    return;
+
+  results_.clear();
+
+  uint64_t frameStart = timestamps_[0] & validMask_;
+  uint64_t frameEnd = frameStart;
+  bool record = profiler.IsEnabled();
+
+  for (uint32_t i = 0; i < frame.written; i++) {
+    uint64_t start = timestamps_[i * 2] & validMask_;
+    uint64_t end = timestamps_[i * 2 + 1] & validMask_;
+    if (end < start)
+      end = start;
+
+    results_.push_back({ frame.names[i], (end - start) * period_ / 1e6 });
+    frameStart = std::min(frameStart, start);
+    frameEnd = std::max(frameEnd, end);
+  }
+
+  frameMilliseconds_ = (frameEnd - frameStart) * period_ / 1e6;
+
+  // GPU and CPU clocks aren't calibrated against each other, the frame is placed at its submit time
+  if (record) {
+    for (uint32_t i = 0; i < frame.written; i++) {
+      uint64_t start = frame.cpuSubmit + static_cast<uint64_t>(((timestamps_[i * 2] & validMask_) - frameStart) * period_);
+      uint64_t end = start + static_cast<uint64_t>(results_[i].milliseconds * 1e6);
+      profiler.RecordOnTrack(profilerTrack_, frame.names[i], start, end);
+    }
+  }
+}
+
+void V8_GpuTimer::BeginFrame(VkCommandBuffer cmd, uint32_t frameIndex) {
+  if (pool_ == VK_NULL_HANDLE)
+    return;
+
+  frame_ = frameIndex % static_cast<uint32_t>(frames_.size());
+  FrameQueries& frame = frames_[frame_];
+
+  if (frame.submitted && frame.written > 0)
+    Resolve(frame);
+
+  frame.names.clear();
+  frame.written = 0;
+  frame.submitted = false;
+
+  vkCmdResetQueryPool(cmd, pool_, frame_ * zonesPerFrame_ * 2, zonesPerFrame_ * 2);
+}
+
+void V8_GpuTimer::EndFrame() {
+  if (pool_ == VK_NULL_HANDLE)
+    return;
+
+  FrameQueries& frame = frames_[frame_];
+  frame.submitted = true;
+  frame.cpuSubmit = V8_Profiler::Now();
+}
+
+uint32_t V8_GpuTimer::BeginZone(VkCommandBuffer cmd, std::string_view name) {
+  if (pool_ == VK_NULL_HANDLE)
+    return V8_INVALID_GPU_ZONE;
+
+  FrameQueries& frame = frames_[frame_];
+  if (frame.written == zonesPerFrame_)
+    return V8_INVALID_GPU_ZONE;
+
+  uint32_t zone = frame.written++;
+  frame.names.push_back(name);
+
+  vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool_, (frame_ * zonesPerFrame_ + zone) * 2);
+  return zone;
+}
+
+void V8_GpuTimer::EndZone(VkCommandBuffer cmd, uint32_t zone) {
+  if (zone == V8_INVALID_GPU_ZONE)
+    return;
+
+  vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool_, (frame_ * zonesPerFrame_ + zone) * 2 + 1);
+}
@@ -1,3 +1,6 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
+#include <Core/MemoryTracker.h>
 #include <Renderer/Types.h>
 
 #include <Core/Logger.h>
@@ -29,7 +32,7 @@ void V8_Shader::Init(const V8_Context& context, VkShaderStageFlagBits type, cons
   createInfo.codeSize = code.size();
   createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
 
-  if (vkCreateShaderModule(context.device_, &createInfo, nullptr, &shaderModule_) != VK_SUCCESS)
+  if (vkCreateShaderModule(context.device_, &createInfo, V8_VulkanAllocator(), &shaderModule_) != VK_SUCCESS)
     V_FATAL("Failed to create shader module from {}", path);
 
   stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -42,7 +45,7 @@ void V8_Shader::Init(const V8_Context& context, VkShaderStageFlagBits type, cons
 
 V8_Shader::~V8_Shader() {
   if (shaderModule_ != VK_NULL_HANDLE)
-    vkDestroyShaderModule(device_, shaderModule_, nullptr);
+    vkDestroyShaderModule(device_, shaderModule_, V8_VulkanAllocator());
 }
 
 void V8_Pipeline::Init(const V8_Context& context, const GraphicsPipelineDescription& description, const V8_RenderConfig& config) {
@@ -121,7 +124,7 @@ void V8_Pipeline::Init(const V8_Context& context, const GraphicsPipelineDescript
   layoutInfo.pushConstantRangeCount = 0;
   layoutInfo.pPushConstantRanges = nullptr;
 
-  if (vkCreatePipelineLayout(context.device_, &layoutInfo, nullptr, &pipelineLayout_) != VK_SUCCESS)
+  if (vkCreatePipelineLayout(context.device_, &layoutInfo, V8_VulkanAllocator(), &pipelineLayout_) != VK_SUCCESS)
     V_FATAL("Failed to create pipeline layout");
 
   VkGraphicsPipelineCreateInfo pipelineInfo {};
@@ -140,7 +143,7 @@ void V8_Pipeline::Init(const V8_Context& context, const GraphicsPipelineDescript
   pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
   pipelineInfo.pDynamicState = &dynamicStateInfo;
 
-  if (vkCreateGraphicsPipelines(context.device_, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline_) != VK_SUCCESS)
+  if (vkCreateGraphicsPipelines(context.device_, VK_NULL_HANDLE, 1, &pipelineInfo, V8_VulkanAllocator(), &pipeline_) != VK_SUCCESS)
     V_FATAL("Failed to create graphics pipeline");
 
   device_ = context.device_;
@@ -148,8 +151,8 @@ void V8_Pipeline::Init(const V8_Context& context, const GraphicsPipelineDescript
 
 V8_Pipeline::~V8_Pipeline() {
   if (pipelineLayout_ != VK_NULL_HANDLE)
-    vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+    vkDestroyPipelineLayout(device_, pipelineLayout_, V8_VulkanAllocator());
 
   if (pipeline_ != VK_NULL_HANDLE)
-    vkDestroyPipeline(device_, pipeline_, nullptr);
+    vkDestroyPipeline(device_, pipeline_, V8_VulkanAllocator());
 }
@@ -1,7 +1,15 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
 #include <Renderer/RenderManager.h>
+#include <Core/MemoryTracker.h>
+#include <Core/Profiler.h>
+
+#include <algorithm>
 
 void V8_RenderManager::CreateRenderer(const std::string& name, const char* vertexShaderPath, const char* fragmentShaderPath, const V8_RenderPassDescription& renderPassDesc, const V8_RenderConfig& config) {
-  renderers_[name].Init(*context_, vertexShaderPath, fragmentShaderPath, renderPassDesc, config);
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
+  renderers_[name].Init(*context_, vertexShaderPath, fragmentShaderPath, renderPassDesc, config, &shaderLoader_);
 }
 
 V8_Renderer* V8_RenderManager::GetRenderer(const std::string& name) {
@@ -12,23 +20,113 @@ V8_Renderer* V8_RenderManager::GetRenderer(const std::string& name) {
 }
 
 void V8_RenderManager::RemoveRenderer(const std::string& name) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
   renderers_.erase(name);
 }
 
 void V8_RenderManager::Render(const std::string& id) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
   if (context_->needsResize_) return;
 
   renderers_[id].Render();
 }
 
 void V8_RenderManager::RenderAll() {
+  V_PROFILE_FUNCTION();
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
   if (context_->needsResize_) return;
 
   for (auto& [id, renderer] : renderers_)
     renderer.Render();
 }
 
+void V8_RenderManager::ExtractAll() {
+  V_PROFILE_FUNCTION();
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
+  if (context_->needsResize_) return;
+
+  for (auto& [id, renderer] : renderers_)
+    renderer.Extract();
+}
+
+void V8_RenderManager::RenderAllExtracted() {
+  V_PROFILE_FUNCTION();
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
+  if (context_->needsResize_) return;
+
+  for (auto& [id, renderer] : renderers_)
+    renderer.RenderExtracted();
+}
+
+void V8_RenderManager::StoreTransforms() {
+  for (auto& [_, renderer] : renderers_)
+    renderer.StoreTransforms();
+}
+
+void V8_RenderManager::SetInterpolation(float alpha) {
+  for (auto& [_, renderer] : renderers_)
+    renderer.SetInterpolation(alpha);
+}
+
+void V8_RenderManager::WaitForFrames() {
+  V_PROFILE_FUNCTION();
+
+  if (context_->needsResize_) return;
+
+  for (auto& [_, renderer] : renderers_)
+    renderer.WaitForFrame();
+}
+
 void V8_RenderManager::HandleResize() {
+  V_MEMORY_SCOPE(V8_MemoryTag::Renderer);
+
   for (auto& [_, renderer] : renderers_)
     renderer.HandleResize();
 }
+
+const V8_RenderStats* V8_RenderManager::GetStats(const std::string& name) const {
+  auto it = renderers_.find(name);
+  if (it == renderers_.end())
+    return nullptr;
+
+  return &it->second.GetStats();
+}
+
+V8_RenderStats V8_RenderManager::GetTotalStats() const {
+  V8_RenderStats total;
+  for (const auto& [_, renderer] : renderers_)
+    total += renderer.GetStats();
+
+  return total;
+}
+
+void V8_RenderManager::AddFrameTimings(V8_FrameSample& sample) const {
+  for (const auto& [_, renderer] : renderers_) {
+    const V8_FrameSample& timings = renderer.GetFrameTimings();
+    sample[V8_FramePhase::Record] += timings[V8_FramePhase::Record];
+    sample[V8_FramePhase::Submit] += timings[V8_FramePhase::Submit];
+    sample[V8_FramePhase::Wait] += timings[V8_FramePhase::Wait];
+
+    // Renderers present one after another, the slowest one is what reaches the screen last
+    sample[V8_FramePhase::Latency] = std::max(sample[V8_FramePhase::Latency], timings[V8_FramePhase::Latency]);
+  }
+}
+
+void V8_RenderManager::DumpStats() const {
+  for (const auto& [name, renderer] : renderers_) {
+    const V8_RenderStats& stats = renderer.GetStats();
+
+    V_REPORT("{}: {} draws, {} instances, {} triangles, {} pipeline binds, {} descriptor binds, {} buffer binds, {} dispatches",
+        name, stats.drawCalls, stats.instances, stats.triangles, stats.pipelineBinds, stats.descriptorBinds, stats.bufferBinds, stats.dispatches);
+
+    if (stats.hasPipelineStatistics)
+      V_REPORT("{}: {} vertices, {} primitives assembled, {} of {} past clipping, {} VS / {} FS / {} CS invocations",
+          name, stats.inputAssemblyVertices, stats.inputAssemblyPrimitives, stats.clippingPrimitives, stats.clippingInvocations,
+          stats.vertexShaderInvocations, stats.fragmentShaderInvocations, stats.computeShaderInvocations);
+  }
+}
@@ -1,3 +1,5 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
 #include <Renderer/Utils.h>
 
 #include <Core/Logger.h>
@@ -17,7 +19,7 @@ void V8_RenderPass::Init(const V8_Context& context, const std::optional<V8_Rende
   createInfo.dependencyCount = static_cast<uint32_t>(description_.dependencies_.size());
   createInfo.pDependencies = description_.dependencies_.data();
 
-  if (vkCreateRenderPass(context.device_, &createInfo, nullptr, &renderPass_) != VK_SUCCESS)
+  if (vkCreateRenderPass(context.device_, &createInfo, V8_VulkanAllocator(), &renderPass_) != VK_SUCCESS)
     V_FATAL("Failed to create render pass");
 
   device_ = context.device_;
@@ -25,5 +27,5 @@ void V8_RenderPass::Init(const V8_Context& context, const std::optional<V8_Rende
 
 V8_RenderPass::~V8_RenderPass() {
   if (renderPass_ != VK_NULL_HANDLE)
-    vkDestroyRenderPass(device_, renderPass_, nullptr);
+    vkDestroyRenderPass(device_, renderPass_, V8_VulkanAllocator());
 }
@@ -0,0 +1,122 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
+#include <Renderer/RenderStats.h>
+#include <Core/Utils.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+  // Results come back in bit order, matching results_
+  constexpr VkQueryPipelineStatisticFlags statisticFlags =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+}
+
+V8_RenderStats& V8_RenderStats::operator+=(const V8_RenderStats& other) {
+  drawCalls += other.drawCalls;
+  instances += other.instances;
+  triangles += other.triangles;
+  pipelineBinds += other.pipelineBinds;
+  descriptorBinds += other.descriptorBinds;
+  bufferBinds += other.bufferBinds;
+  dispatches += other.dispatches;
+
+  hasPipelineStatistics |= other.hasPipelineStatistics;
+  inputAssemblyVertices += other.inputAssemblyVertices;
+  inputAssemblyPrimitives += other.inputAssemblyPrimitives;
+  vertexShaderInvocations += other.vertexShaderInvocations;
+  clippingInvocations += other.clippingInvocations;
+  clippingPrimitives += other.clippingPrimitives;
+  fragmentShaderInvocations += other.fragmentShaderInvocations;
+  computeShaderInvocations += other.computeShaderInvocations;
+
+  return *this;
+}
+
+V8_PipelineStatistics::~V8_PipelineStatistics() {
+  Shutdown();
+}
+
+void V8_PipelineStatistics::Init(V8_Context& context, uint32_t framesInFlight) {
+  if (!context.pipelineStatisticsQuery_)
+    return;
+
+  device_ = context.device_;
+
+  VkQueryPoolCreateInfo poolInfo {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+  poolInfo.queryCount = framesInFlight;
+  poolInfo.pipelineStatistics = statisticFlags;
+
+  VK_CHECK(vkCreateQueryPool(device_, &poolInfo, V8_VulkanAllocator(), &pool_));
+
+  frames_.assign(framesInFlight, {});
+}
+
+void V8_PipelineStatistics::Shutdown() {
+  if (pool_ != VK_NULL_HANDLE)
+    vkDestroyQueryPool(device_, pool_, V8_VulkanAllocator());
+
+  pool_ = VK_NULL_HANDLE;
+  frames_.clear();
+  resolved_ = false;
+}
+
+void V8_PipelineStatistics::Begin(VkCommandBuffer cmd, uint32_t frameIndex) {
+  if (pool_ == VK_NULL_HANDLE)
+    return;
+
+  frame_ = frameIndex % static_cast<uint32_t>(frames_.size());
+  FrameQuery& frame = frames_[frame_];
+
+  // The frame's fence has signaled, so this doesn't wait
+  if (frame.submitted) {
+    uint64_t results[7];
+    if (vkGetQueryPoolResults(device_, pool_, frame_, 1, sizeof(results), results, sizeof(results), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+      std::copy(std::begin(results), std::end(results), results_);
+      resolved_ = true;
+    }
+  }
+
+  frame.submitted = false;
+
+  vkCmdResetQueryPool(cmd, pool_, frame_, 1);
+  vkCmdBeginQuery(cmd, pool_, frame_, 0);
+  frame.active = true;
+}
+
+void V8_PipelineStatistics::End(VkCommandBuffer cmd) {
+  if (pool_ == VK_NULL_HANDLE || !frames_[frame_].active)
+    return;
+
+  vkCmdEndQuery(cmd, pool_, frame_);
+}
+
+void V8_PipelineStatistics::EndFrame() {
+  if (pool_ == VK_NULL_HANDLE || !frames_[frame_].active)
+    return;
+
+  frames_[frame_].active = false;
+  frames_[frame_].submitted = true;
+}
+
+void V8_PipelineStatistics::Fill(V8_RenderStats& stats) const {
+  stats.hasPipelineStatistics = resolved_;
+  if (!resolved_)
+    return;
+
+  stats.inputAssemblyVertices = results_[0];
+  stats.inputAssemblyPrimitives = results_[1];
+  stats.vertexShaderInvocations = results_[2];
+  stats.clippingInvocations = results_[3];
+  stats.clippingPrimitives = results_[4];
+  stats.fragmentShaderInvocations = results_[5];
+  stats.computeShaderInvocations = results_[6];
+}
@@ -1,30 +1,32 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
 #include <Renderer/Renderer.h>
+#include <Scene/Meshlet.h>
 #include <Scene/Types.h>
+#include <Core/Profiler.h>
 
-#include <fstream>
+#include <algorithm>
 #include <vector>
 
-std::vector<char> ReadFile(const std::string& filename) {
-  std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-  if (!file.is_open()) {
-    V_ERROR("failed to open file {}", filename);
-    return {};
-  }
+void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPath, const char* fragmentShaderPath, const std::optional<V8_RenderPassDescription>& renderPassDesc, const V8_RenderConfig& config, V8_ShaderLoader* shaderLoader) {
+  context_ = &ctx;
+  config_ = config;
 
-  size_t fileSize = (size_t)file.tellg();
-  std::vector<char> buffer(fileSize);
-  file.seekg(0);
-  file.read(buffer.data(), fileSize);
-  file.close();
+  V8_ShaderLoader localLoader;
+  V8_ShaderLoader& loader = shaderLoader != nullptr ? *shaderLoader : localLoader;
 
-  return buffer;
-}
+  V8_RenderPassDescription desc = renderPassDesc.value_or(V8_RenderPassDescription::Default(context_->swapchainImageFormat_, config));
 
-void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPath, const char* fragmentShaderPath, const std::optional<V8_RenderPassDescription>& renderPassDesc, const V8_RenderConfig& config) {
-  context_ = &ctx;
+  // Offscreen images are never presented, leave them ready to be copied out instead
+  if (context_->IsHeadless()) {
+    for (auto& attachment : desc.attachments_) {
+      if (attachment.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+        attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    }
+  }
 
-  V8_RenderPassDescription desc = renderPassDesc.value_or(V8_RenderPassDescription::Default(context_->swapchainImageFormat_, config));
+  if (!desc.attachments_.empty())
+    outputLayout_ = desc.attachments_[0].finalLayout;
 
   VkRenderPassCreateInfo renderPassInfo {};
   renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -35,7 +37,7 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
   renderPassInfo.dependencyCount = static_cast<uint32_t>(desc.dependencies_.size());
   renderPassInfo.pDependencies = desc.dependencies_.data();
 
-  if (vkCreateRenderPass(context_->device_, &renderPassInfo, nullptr, &renderPass_) != VK_SUCCESS)
+  if (vkCreateRenderPass(context_->device_, &renderPassInfo, V8_VulkanAllocator(), &renderPass_) != VK_SUCCESS)
     V_FATAL("Failed to create render pass");
 
   VkDescriptorSetLayoutBinding descriptorBinding {};
@@ -50,19 +52,26 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
   descriptorLayoutInfo.bindingCount = 1;
   descriptorLayoutInfo.pBindings = &descriptorBinding;
 
-  VK_CHECK(vkCreateDescriptorSetLayout(context_->device_, &descriptorLayoutInfo, nullptr, &descriptorSetLayout_));
+  VK_CHECK(vkCreateDescriptorSetLayout(context_->device_, &descriptorLayoutInfo, V8_VulkanAllocator(), &descriptorSetLayout_));
 
   VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
   pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
   pipelineLayoutInfo.setLayoutCount = 0;
   pipelineLayoutInfo.pSetLayouts = nullptr;
-  pipelineLayoutInfo.pushConstantRangeCount = 0;
-  pipelineLayoutInfo.pPushConstantRanges = nullptr;
 
-  VK_CHECK(vkCreatePipelineLayout(context_->device_, &pipelineLayoutInfo, nullptr, &pipelineLayout_));
+  // Model-view-projection per draw, the same matrix meshlet culling extracts its planes from
+  VkPushConstantRange pushConstantRange {};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = sizeof(Matrix4);
 
-  std::vector<char> vertShaderCode = ReadFile(vertexShaderPath);
-  std::vector<char> fragShaderCode = ReadFile(fragmentShaderPath);
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+  VK_CHECK(vkCreatePipelineLayout(context_->device_, &pipelineLayoutInfo, V8_VulkanAllocator(), &pipelineLayout_));
+
+  std::vector<char> vertShaderCode = loader.Get(vertexShaderPath);
+  std::vector<char> fragShaderCode = loader.Get(fragmentShaderPath);
 
   VkShaderModuleCreateInfo vertShaderModuleInfo {};
   vertShaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -77,10 +86,10 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
   VkShaderModule vertShaderModule;
   VkShaderModule fragShaderModule;
 
-  if (vkCreateShaderModule(context_->device_, &vertShaderModuleInfo, nullptr, &vertShaderModule) != VK_SUCCESS)
+  if (vkCreateShaderModule(context_->device_, &vertShaderModuleInfo, V8_VulkanAllocator(), &vertShaderModule) != VK_SUCCESS)
     V_FATAL("Failed to create vertex shader module");
 
-  if (vkCreateShaderModule(context_->device_, &fragShaderModuleInfo, nullptr, &fragShaderModule) != VK_SUCCESS)
+  if (vkCreateShaderModule(context_->device_, &fragShaderModuleInfo, V8_VulkanAllocator(), &fragShaderModule) != VK_SUCCESS)
     V_FATAL("Failed to create fragment shader module");
 
   VkPipelineShaderStageCreateInfo vertShaderStageInfo {};
@@ -112,15 +121,15 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
   inputAssemblyInfo.topology = static_cast<VkPrimitiveTopology>(config.inputTopology);
   inputAssemblyInfo.primitiveRestartEnable = static_cast<VkBool32>(config.primitiveRestartEnable);
 
-  std::vector<VkDynamicState> dynamicStates = {
+  VkDynamicState dynamicStates[] = {
     VK_DYNAMIC_STATE_VIEWPORT,
     VK_DYNAMIC_STATE_SCISSOR
   };
 
   VkPipelineDynamicStateCreateInfo dynamicStateInfo {};
   dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-  dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-  dynamicStateInfo.pDynamicStates = dynamicStates.data();
+  dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(std::size(dynamicStates));
+  dynamicStateInfo.pDynamicStates = dynamicStates;
 
   VkPipelineViewportStateCreateInfo viewportInfo {};
   viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
@@ -195,10 +204,10 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
   pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
   pipelineInfo.pDynamicState = &dynamicStateInfo;
 
-  VK_CHECK(vkCreateGraphicsPipelines(context_->device_, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline_));
+  VK_CHECK(vkCreateGraphicsPipelines(context_->device_, context_->pipelineCache_, 1, &pipelineInfo, V8_VulkanAllocator(), &pipeline_));
 
-  vkDestroyShaderModule(context_->device_, vertShaderModule, nullptr);
-  vkDestroyShaderModule(context_->device_, fragShaderModule, nullptr);
+  vkDestroyShaderModule(context_->device_, vertShaderModule, V8_VulkanAllocator());
+  vkDestroyShaderModule(context_->device_, fragShaderModule, V8_VulkanAllocator());
 
   framebuffers_.resize(context_->swapchainImages_.size());
   for (size_t i = 0; i < framebuffers_.size(); i++) {
@@ -211,7 +220,7 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
     framebufferInfo.height = context_->swapchainExtent_.height;
     framebufferInfo.layers = 1;
 
-    if (vkCreateFramebuffer(context_->device_, &framebufferInfo, nullptr, &framebuffers_[i]) != VK_SUCCESS)
+    if (vkCreateFramebuffer(context_->device_, &framebufferInfo, V8_VulkanAllocator(), &framebuffers_[i]) != VK_SUCCESS)
       V_FATAL("Failed to create framebuffer");
   }
 
@@ -226,31 +235,337 @@ void V8_Renderer::V8_Renderer::Init(V8_Context& ctx, const char* vertexShaderPat
     if (vkAllocateCommandBuffers(context_->device_, &allocInfo, &commandBuffers_[i]) != VK_SUCCESS)
       V_FATAL("Failed to allocate command buffers");
   }
+
+  if (config.meshletCullShaderPath != nullptr)
+    CreateCullPipeline(config.meshletCullShaderPath, loader);
+
+  if (config.gpuTimers)
+    gpuTimer_.Init(*context_, static_cast<uint32_t>(commandBuffers_.size()));
+
+  if (config.pipelineStatistics)
+    pipelineStatistics_.Init(*context_, static_cast<uint32_t>(commandBuffers_.size()));
+}
+
+void V8_Renderer::CreateCullPipeline(const char* shaderPath, V8_ShaderLoader& shaderLoader) {
+  VkDescriptorSetLayoutBinding bindings[2] {};
+  for (uint32_t i = 0; i < 2; i++) {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  }
+
+  VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo {};
+  descriptorLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  descriptorLayoutInfo.bindingCount = 2;
+  descriptorLayoutInfo.pBindings = bindings;
+
+  VK_CHECK(vkCreateDescriptorSetLayout(context_->device_, &descriptorLayoutInfo, V8_VulkanAllocator(), &cullDescriptorSetLayout_));
+
+  VkPushConstantRange pushConstantRange {};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = sizeof(V8_MeshletCullParams);
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &cullDescriptorSetLayout_;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+  VK_CHECK(vkCreatePipelineLayout(context_->device_, &pipelineLayoutInfo, V8_VulkanAllocator(), &cullPipelineLayout_));
+
+  std::vector<char> shaderCode = shaderLoader.Get(shaderPath);
+
+  VkShaderModuleCreateInfo shaderModuleInfo {};
+  shaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  shaderModuleInfo.codeSize = shaderCode.size();
+  shaderModuleInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+
+  VkShaderModule shaderModule;
+  if (vkCreateShaderModule(context_->device_, &shaderModuleInfo, V8_VulkanAllocator(), &shaderModule) != VK_SUCCESS)
+    V_FATAL("Failed to create meshlet culling shader module");
+
+  VkComputePipelineCreateInfo pipelineInfo {};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  pipelineInfo.stage.module = shaderModule;
+  pipelineInfo.stage.pName = "main";
+  pipelineInfo.layout = cullPipelineLayout_;
+
+  VK_CHECK(vkCreateComputePipelines(context_->device_, context_->pipelineCache_, 1, &pipelineInfo, V8_VulkanAllocator(), &cullPipeline_));
+
+  vkDestroyShaderModule(context_->device_, shaderModule, V8_VulkanAllocator());
+}
+
+VkDescriptorSet V8_Renderer::AllocateCullDescriptorSet(const V8_StaticMesh& mesh, VkBuffer commandBuffer) {
+  CullFrame& frame = cullFrames_[currentFrame_];
+
+  VkDescriptorSetAllocateInfo allocInfo {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &cullDescriptorSetLayout_;
+
+  VkDescriptorSet set = VK_NULL_HANDLE;
+  while (frame.current < frame.pools.size()) {
+    allocInfo.descriptorPool = frame.pools[frame.current];
+    if (vkAllocateDescriptorSets(context_->device_, &allocInfo, &set) == VK_SUCCESS)
+      break;
+
+    set = VK_NULL_HANDLE;
+    frame.current++;
+  }
+
+  if (set == VK_NULL_HANDLE) {
+    VkDescriptorPoolSize poolSize {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 128;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 64;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    VkDescriptorPool pool;
+    VK_CHECK(vkCreateDescriptorPool(context_->device_, &poolInfo, V8_VulkanAllocator(), &pool));
+    frame.pools.push_back(pool);
+    frame.current = frame.pools.size() - 1;
+
+    allocInfo.descriptorPool = pool;
+    VK_CHECK(vkAllocateDescriptorSets(context_->device_, &allocInfo, &set));
+  }
+
+  VkDescriptorBufferInfo bufferInfos[2] {};
+  bufferInfos[0].buffer = mesh.meshletBuffer;
+  bufferInfos[0].range = VK_WHOLE_SIZE;
+  bufferInfos[1].buffer = commandBuffer;
+  bufferInfos[1].range = VK_WHOLE_SIZE;
+
+  VkWriteDescriptorSet writes[2] {};
+  for (uint32_t i = 0; i < 2; i++) {
+    writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[i].dstSet = set;
+    writes[i].dstBinding = i;
+    writes[i].descriptorCount = 1;
+    writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[i].pBufferInfo = &bufferInfos[i];
+  }
+
+  vkUpdateDescriptorSets(context_->device_, 2, writes, 0, nullptr);
+  return set;
+}
+
+void V8_Renderer::RecordMeshletCulling(VkCommandBuffer cmd) {
+  if (cullCommandCount_ == 0)
+    return;
+
+  float aspectRatio = static_cast<float>(context_->swapchainExtent_.width) / static_cast<float>(context_->swapchainExtent_.height);
+  Matrix4 viewProjection = camera_->GetProjectionMatrix(aspectRatio) * camera_->GetViewMatrix();
+
+  // The frame fence has been waited on, so this slot's sets and commands are free again
+  if (cullFrames_.size() <= currentFrame_)
+    cullFrames_.resize(currentFrame_ + 1);
+
+  CullFrame& frame = cullFrames_[currentFrame_];
+  for (auto pool : frame.pools)
+    vkResetDescriptorPool(context_->device_, pool, 0);
+  frame.current = 0;
+
+  if (frame.commandCapacity < cullCommandCount_) {
+    if (frame.commandBuffer != VK_NULL_HANDLE)
+      vmaDestroyBuffer(context_->allocator_, frame.commandBuffer, frame.commandAllocation);
+
+    frame.commandCapacity = std::max(cullCommandCount_, frame.commandCapacity * 2);
+
+    VkBufferCreateInfo bufferInfo {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = frame.commandCapacity * sizeof(VkDrawIndexedIndirectCommand);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocInfo {};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+    VK_CHECK(vmaCreateBuffer(context_->allocator_, &bufferInfo, &allocInfo, &frame.commandBuffer, &frame.commandAllocation, nullptr));
+  }
+
+  vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline_);
+  stats_.pipelineBinds++;
+
+  for (const auto& draw : drawList_) {
+    if (!draw.meshletCulled)
+      continue;
+
+    V8_MeshletCullParams params {};
+    V8_ExtractFrustumPlanes(viewProjection * draw.model, params.frustumPlanes);
+    params.cameraPosition = glm::inverse(draw.model) * glm::vec4(camera_->position, 1.0f);
+    params.meshletCount = static_cast<uint32_t>(draw.mesh->meshlets.size());
+    params.firstCommand = draw.firstCommand;
+
+    VkDescriptorSet set = AllocateCullDescriptorSet(*draw.mesh, frame.commandBuffer);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout_, 0, 1, &set, 0, nullptr);
+    vkCmdPushConstants(cmd, cullPipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(V8_MeshletCullParams), &params);
+    vkCmdDispatch(cmd, (params.meshletCount + 63) / 64, 1, 1);
+    stats_.descriptorBinds++;
+    stats_.dispatches++;
+  }
+
+  VkMemoryBarrier barrier {};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
 }
 
 V8_Renderer::V8_Renderer::~V8_Renderer() {
   vkDeviceWaitIdle(context_->device_);
 
-  vkDestroyDescriptorSetLayout(context_->device_, descriptorSetLayout_, nullptr);
+  gpuTimer_.Shutdown();
+  pipelineStatistics_.Shutdown();
+
+  vkDestroyDescriptorSetLayout(context_->device_, descriptorSetLayout_, V8_VulkanAllocator());
+
+  for (const auto& frame : cullFrames_) {
+    for (auto pool : frame.pools)
+      vkDestroyDescriptorPool(context_->device_, pool, V8_VulkanAllocator());
+
+    if (frame.commandBuffer != VK_NULL_HANDLE)
+      vmaDestroyBuffer(context_->allocator_, frame.commandBuffer, frame.commandAllocation);
+  }
+
+  if (cullPipeline_ != VK_NULL_HANDLE)
+    vkDestroyPipeline(context_->device_, cullPipeline_, V8_VulkanAllocator());
+
+  if (cullPipelineLayout_ != VK_NULL_HANDLE)
+    vkDestroyPipelineLayout(context_->device_, cullPipelineLayout_, V8_VulkanAllocator());
+
+  if (cullDescriptorSetLayout_ != VK_NULL_HANDLE)
+    vkDestroyDescriptorSetLayout(context_->device_, cullDescriptorSetLayout_, V8_VulkanAllocator());
 
   for (auto framebuffer : framebuffers_)
-    vkDestroyFramebuffer(context_->device_, framebuffer, nullptr);
+    vkDestroyFramebuffer(context_->device_, framebuffer, V8_VulkanAllocator());
 
   if (pipelineLayout_ != VK_NULL_HANDLE)
-    vkDestroyPipelineLayout(context_->device_, pipelineLayout_, nullptr);
+    vkDestroyPipelineLayout(context_->device_, pipelineLayout_, V8_VulkanAllocator());
 
   if (pipeline_ != VK_NULL_HANDLE)
-    vkDestroyPipeline(context_->device_, pipeline_, nullptr);
+    vkDestroyPipeline(context_->device_, pipeline_, V8_VulkanAllocator());
 
   if (renderPass_ != VK_NULL_HANDLE)
-    vkDestroyRenderPass(context_->device_, renderPass_, nullptr);
+    vkDestroyRenderPass(context_->device_, renderPass_, V8_VulkanAllocator());
 
   scene_ = nullptr;
 }
 
 void V8_Renderer::V8_Renderer::Render() {
-  if (scene_ == nullptr) {
-    V_WARNING("No scene bound to renderer");
+  Extract();
+  RenderExtracted();
+}
+
+V8_StaticMesh* V8_Renderer::FindMesh(V8_Entity entity) {
+  if (V8_StaticMesh* mesh = scene_->registry.GetComponent<V8_StaticMesh>(entity))
+    return mesh;
+
+  // Streamed meshes are drawn only while the asset manager has them resident
+  if (V8_StreamedMesh* streamed = scene_->registry.GetComponent<V8_StreamedMesh>(entity))
+    return streamed->handle.Get();
+
+  return nullptr;
+}
+
+void V8_Renderer::WaitForFrame() {
+  V_PROFILE_FUNCTION();
+
+  // Bounded, a minimized or occluded window may never show the frame
+  MeasurePresentLatency(100'000'000);
+
+  vkWaitForFences(context_->device_, 1, &context_->inFlightFences_[currentFrame_], VK_TRUE, UINT64_MAX);
+}
+
+void V8_Renderer::MeasurePresentLatency(uint64_t timeout) {
+  if (!context_->presentWait_ || context_->IsHeadless())
+    return;
+
+  // Present ids complete in order, a finished id means every older one is on screen too
+  for (size_t i = pendingPresents_.size(); i-- > 0;) {
+    uint64_t wait = i + 1 == pendingPresents_.size() ? timeout : 0;
+    if (context_->waitForPresent_(context_->device_, context_->swapchain_, pendingPresents_[i].id, wait) != VK_SUCCESS)
+      continue;
+
+    presentLatency_ = (V8_Profiler::Now() - pendingPresents_[i].acquireStart) / 1e6;
+    pendingPresents_.erase(pendingPresents_.begin(), pendingPresents_.begin() + i + 1);
+    break;
+  }
+}
+
+void V8_Renderer::StoreTransforms() {
+  if (scene_ == nullptr)
+    return;
+
+  for (auto& e : scene_->registry.entities_) {
+    if (V8_StaticMesh* mesh = FindMesh(e))
+      mesh->StoreTransform();
+  }
+}
+
+void V8_Renderer::Extract() {
+  V_PROFILE_FUNCTION();
+
+  drawList_ = {};
+  extractedMeshes_.clear();
+  cullCommandCount_ = 0;
+  camera_.reset();
+  extracted_ = scene_ != nullptr;
+
+  if (scene_ == nullptr)
+    return;
+
+  drawList_.reserve(scene_->registry.entities_.size());
+
+  if (scene_->cam != nullptr)
+    camera_ = *scene_->cam;
+
+  for (auto& e : scene_->registry.entities_) {
+    V8_StaticMesh* mesh = nullptr;
+    if (std::shared_ptr<V8_StaticMesh> owned = scene_->registry.GetSharedComponent<V8_StaticMesh>(e)) {
+      mesh = owned.get();
+      extractedMeshes_.push_back(std::move(owned));
+    } else {
+      mesh = FindMesh(e);
+    }
+
+    if (mesh == nullptr)
+      continue;
+
+    uint32_t lod = 0;
+    if (camera_.has_value() && !mesh->lods.empty())
+      lod = mesh->SelectLOD(*camera_, static_cast<float>(context_->swapchainExtent_.height), config_.lodErrorThreshold);
+
+    // Coarser LODs are already cheap, cluster culling only pays off at full detail
+    bool meshletCulled = cullPipeline_ != VK_NULL_HANDLE && camera_.has_value() && lod == 0 && !mesh->meshlets.empty() && mesh->meshletBuffer != VK_NULL_HANDLE;
+
+    drawList_.push_back({ mesh, mesh->GetModelMatrix(interpolation_), lod, meshletCulled, cullCommandCount_ });
+    if (meshletCulled)
+      cullCommandCount_ += static_cast<uint32_t>(mesh->meshlets.size());
+  }
+}
+
+void V8_Renderer::RenderExtracted() {
+  V_PROFILE_FUNCTION();
+
+  timings_ = {};
+
+  // Already measured if WaitForFrame waited on present. Either way it belongs to an earlier frame.
+  MeasurePresentLatency(0);
+  timings_[V8_FramePhase::Latency] = presentLatency_;
+  presentLatency_ = 0.0;
+
+  if (!extracted_) {
+    V_WARNING_LIMITED("No scene bound to renderer");
     return;
   }
 
@@ -260,10 +575,28 @@ void V8_Renderer::V8_Renderer::Render() {
     return;
   }
 
-  vkWaitForFences(context_->device_, 1, &context_->inFlightFences_[currentFrame_], VK_TRUE, UINT64_MAX);
+  uint64_t waitStart = V8_Profiler::Now();
+  {
+    V_PROFILE_SCOPE("Wait for frame fence");
+    vkWaitForFences(context_->device_, 1, &context_->inFlightFences_[currentFrame_], VK_TRUE, UINT64_MAX);
+  }
+
+  // The slot's last frame is done with its meshes, they go back to Extract to be released on the main thread
+  if (frameMeshes_.size() <= currentFrame_)
+    frameMeshes_.resize(currentFrame_ + 1);
+  std::swap(frameMeshes_[currentFrame_], extractedMeshes_);
+
+  // Headless frames map one to one onto offscreen images, guarded by the frame fence
+  uint32_t imageIndex = currentFrame_;
+  VkResult res = VK_SUCCESS;
+  uint64_t acquireStart = V8_Profiler::Now();
+  if (!context_->IsHeadless()) {
+    V_PROFILE_SCOPE("Acquire swapchain image");
+    res = vkAcquireNextImageKHR(context_->device_, context_->swapchain_, UINT64_MAX, context_->imageAvailableSemaphores_[currentFrame_], VK_NULL_HANDLE, &imageIndex);
+  }
 
-  uint32_t imageIndex;
-  VkResult res = vkAcquireNextImageKHR(context_->device_, context_->swapchain_, UINT64_MAX, context_->imageAvailableSemaphores_[currentFrame_], VK_NULL_HANDLE, &imageIndex);
+  uint64_t recordStart = V8_Profiler::Now();
+  timings_[V8_FramePhase::Wait] = (recordStart - waitStart) / 1e6;
 
   if (res == VK_ERROR_OUT_OF_DATE_KHR) {
     V_DEBUG("Swapchain out of date");
@@ -284,6 +617,16 @@ void V8_Renderer::V8_Renderer::Render() {
   if (vkBeginCommandBuffer(commandBuffers_[currentFrame_], &beginInfo) != VK_SUCCESS)
     V_FATAL("Failed to begin recording command buffer");
 
+  gpuTimer_.BeginFrame(commandBuffers_[currentFrame_], currentFrame_);
+  pipelineStatistics_.Begin(commandBuffers_[currentFrame_], currentFrame_);
+  stats_ = {};
+
+  if (cullPipeline_ != VK_NULL_HANDLE && camera_.has_value()) {
+    uint32_t cullZone = gpuTimer_.BeginZone(commandBuffers_[currentFrame_], "Meshlet culling");
+    RecordMeshletCulling(commandBuffers_[currentFrame_]);
+    gpuTimer_.EndZone(commandBuffers_[currentFrame_], cullZone);
+  }
+
   VkRenderPassBeginInfo renderPassInfo {};
   renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
   renderPassInfo.renderPass = renderPass_;
@@ -295,9 +638,11 @@ void V8_Renderer::V8_Renderer::Render() {
   renderPassInfo.clearValueCount = 1;
   renderPassInfo.pClearValues = &clearColor;
 
+  uint32_t passZone = gpuTimer_.BeginZone(commandBuffers_[currentFrame_], "Main pass");
   vkCmdBeginRenderPass(commandBuffers_[currentFrame_], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
   vkCmdBindPipeline(commandBuffers_[currentFrame_], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+  stats_.pipelineBinds++;
 
   VkViewport viewport {};
   viewport.x = 0.0f;
@@ -313,28 +658,75 @@ void V8_Renderer::V8_Renderer::Render() {
   scissor.extent = context_->swapchainExtent_;
   vkCmdSetScissor(commandBuffers_[currentFrame_], 0, 1, &scissor);
 
-  for (auto& e : scene_->registry.entities_) {
-    if (scene_->registry.GetComponent<V8_StaticMesh>(e) == nullptr)
-      continue;
+  // Without a camera meshes are drawn in clip space as given
+  Matrix4 viewProjection(1.0f);
+  if (camera_.has_value())
+    viewProjection = camera_->GetProjectionMatrix(viewport.width / viewport.height) * camera_->GetViewMatrix();
 
-    V8_StaticMesh* mesh = scene_->registry.GetComponent<V8_StaticMesh>(e);
+  for (const auto& draw : drawList_) {
+    V8_StaticMesh* mesh = draw.mesh;
+
+    Matrix4 modelViewProjection = viewProjection * draw.model;
+    vkCmdPushConstants(commandBuffers_[currentFrame_], pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Matrix4), &modelViewProjection);
 
     VkBuffer vertexBuffers[] = { mesh->vertexBuffer };
     VkDeviceSize offsets[] = { 0 };
 
-    VkBuffer indexBuffers[] = { mesh->indexBuffer };
-
     vkCmdBindVertexBuffers(commandBuffers_[currentFrame_], 0, 1, vertexBuffers, offsets);
     vkCmdBindIndexBuffer(commandBuffers_[currentFrame_], mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    stats_.bufferBinds += 2;
+    stats_.instances++;
+
+    if (draw.meshletCulled) {
+      uint32_t meshletCount = static_cast<uint32_t>(mesh->meshlets.size());
+      uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+      VkBuffer commands = cullFrames_[currentFrame_].commandBuffer;
+      VkDeviceSize offset = static_cast<VkDeviceSize>(draw.firstCommand) * stride;
+
+      if (context_->multiDrawIndirect_) {
+        vkCmdDrawIndexedIndirect(commandBuffers_[currentFrame_], commands, offset, meshletCount, stride);
+      } else {
+        for (uint32_t i = 0; i < meshletCount; i++)
+          vkCmdDrawIndexedIndirect(commandBuffers_[currentFrame_], commands, offset + i * stride, 1, stride);
+      }
+
+      // Meshlets cover the full detail level, how many survive culling is only known on the GPU
+      stats_.drawCalls += context_->multiDrawIndirect_ ? 1 : meshletCount;
+      stats_.triangles += (mesh->lods.empty() ? mesh->indices.size() : mesh->lods[0].indexCount) / 3;
+      continue;
+    }
+
+    if (mesh->lods.empty()) {
+      vkCmdDrawIndexed(commandBuffers_[currentFrame_], static_cast<uint32_t>(mesh->indices.size()), 1, 0, 0, 0);
+      stats_.drawCalls++;
+      stats_.triangles += mesh->indices.size() / 3;
+      continue;
+    }
 
-    vkCmdDrawIndexed(commandBuffers_[currentFrame_], static_cast<uint32_t>(mesh->indices.size()), 1, 0, 0, 0);
+    const V8_MeshLOD& lod = mesh->lods[draw.lod];
+    vkCmdDrawIndexed(commandBuffers_[currentFrame_], lod.indexCount, 1, lod.indexOffset, 0, 0);
+    stats_.drawCalls++;
+    stats_.triangles += lod.indexCount / 3;
   }
 
   vkCmdEndRenderPass(commandBuffers_[currentFrame_]);
+  gpuTimer_.EndZone(commandBuffers_[currentFrame_], passZone);
+  pipelineStatistics_.End(commandBuffers_[currentFrame_]);
 
   if (vkEndCommandBuffer(commandBuffers_[currentFrame_]) != VK_SUCCESS)
     V_FATAL("Failed to record command buffer");
 
+  uint64_t submitStart = V8_Profiler::Now();
+  timings_[V8_FramePhase::Record] = (submitStart - recordStart) / 1e6;
+
+  V_PROFILE_SCOPE("Submit and present");
+
+  gpuTimer_.EndFrame();
+  pipelineStatistics_.EndFrame();
+
+  pipelineStatistics_.Fill(stats_);
+  lastStats_ = stats_;
+
   VkSubmitInfo submitInfo {};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submitInfo.commandBufferCount = 1;
@@ -343,15 +735,23 @@ void V8_Renderer::V8_Renderer::Render() {
   VkSemaphore waitSemaphores[] = { context_->imageAvailableSemaphores_[currentFrame_] };
   VkSemaphore signalSemaphores[] = { context_->renderFinishedSemaphores_[imageIndex] };
   VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-  submitInfo.waitSemaphoreCount = 1;
+  submitInfo.waitSemaphoreCount = context_->IsHeadless() ? 0 : 1;
   submitInfo.pWaitSemaphores = waitSemaphores;
-  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.signalSemaphoreCount = context_->IsHeadless() ? 0 : 1;
   submitInfo.pSignalSemaphores = signalSemaphores;
   submitInfo.pWaitDstStageMask = waitStages;
 
   if (vkQueueSubmit(context_->graphicsQueue_, 1, &submitInfo, context_->inFlightFences_[currentFrame_]) != VK_SUCCESS)
     V_FATAL("Failed to submit draw command buffer");
 
+  lastImageIndex_ = imageIndex;
+
+  if (context_->IsHeadless()) {
+    timings_[V8_FramePhase::Submit] = (V8_Profiler::Now() - submitStart) / 1e6;
+    currentFrame_ = (currentFrame_ + 1) % context_->swapchainImages_.size();
+    return;
+  }
+
   VkPresentInfoKHR presentInfo {};
   presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
   presentInfo.waitSemaphoreCount = 1;
@@ -361,7 +761,24 @@ void V8_Renderer::V8_Renderer::Render() {
   presentInfo.pImageIndices = &imageIndex;
   presentInfo.pResults = nullptr;
 
+  VkPresentIdKHR presentIdInfo {};
+  if (context_->presentWait_) {
+    presentId_++;
+    presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds = &presentId_;
+    presentInfo.pNext = &presentIdInfo;
+
+    // A hidden window may never show them, keep only the last few
+    if (pendingPresents_.size() == 8)
+      pendingPresents_.erase(pendingPresents_.begin());
+    pendingPresents_.push_back({ presentId_, acquireStart });
+  }
+
   res = vkQueuePresentKHR(context_->presentQueue_, &presentInfo);
+
+  uint64_t presentEnd = V8_Profiler::Now();
+  timings_[V8_FramePhase::Submit] = (presentEnd - submitStart) / 1e6;
   if (res == VK_ERROR_OUT_OF_DATE_KHR) {
     V_DEBUG("Swapchain out of date (failed to present swapchain image)");
     context_->needsResize_ = true;
@@ -375,7 +792,7 @@ void V8_Renderer::V8_Renderer::Render() {
 
 void V8_Renderer::V8_Renderer::HandleResize() {
   for (auto& fb : framebuffers_)
-    vkDestroyFramebuffer(context_->device_, fb, nullptr);
+    vkDestroyFramebuffer(context_->device_, fb, V8_VulkanAllocator());
 
   framebuffers_.resize(context_->swapchainImages_.size());
   for (size_t i = 0; i < framebuffers_.size(); i++) {
@@ -388,9 +805,13 @@ void V8_Renderer::V8_Renderer::HandleResize() {
     framebufferInfo.height = context_->swapchainExtent_.height;
     framebufferInfo.layers = 1;
 
-    if (vkCreateFramebuffer(context_->device_, &framebufferInfo, nullptr, &framebuffers_[i]) != VK_SUCCESS)
+    if (vkCreateFramebuffer(context_->device_, &framebufferInfo, V8_VulkanAllocator(), &framebuffers_[i]) != VK_SUCCESS)
       V_FATAL("Failed to create framebuffer");
   }
 
   currentFrame_ = 0;
+
+  // Present ids count per swapchain, the recreated one starts over
+  presentId_ = 0;
+  pendingPresents_.clear();
 }
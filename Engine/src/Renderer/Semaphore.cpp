@@ -1,3 +1,5 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
 #include <Renderer/Utils.h>
 #include <Core/Logger.h>
 
@@ -7,13 +9,13 @@ void V8_Semaphore::Init(const V8_Context& context) {
   VkSemaphoreCreateInfo semaphoreInfo{};
   semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-  if (vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &semaphore_) != VK_SUCCESS) 
+  if (vkCreateSemaphore(device_, &semaphoreInfo, V8_VulkanAllocator(), &semaphore_) != VK_SUCCESS) 
     V_FATAL("Failed to create semaphore");
 }
 
 V8_Semaphore::~V8_Semaphore() {
   if (semaphore_ != VK_NULL_HANDLE) {
-    vkDestroySemaphore(device_, semaphore_, nullptr);
+    vkDestroySemaphore(device_, semaphore_, V8_VulkanAllocator());
     semaphore_ = VK_NULL_HANDLE;
   }
 }
@@ -0,0 +1,51 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Renderer
+
+#include <Renderer/ShaderLoader.h>
+#include <Core/Profiler.h>
+#include <Core/Logger.h>
+
+#include <fstream>
+
+static std::vector<char> ReadFile(const std::string& filename) {
+  V_PROFILE_SCOPE("Read shader");
+
+  std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+  if (!file.is_open()) {
+    V_ERROR("Failed to open file {}", filename);
+    return {};
+  }
+
+  size_t fileSize = (size_t)file.tellg();
+  std::vector<char> buffer(fileSize);
+  file.seekg(0);
+  file.read(buffer.data(), fileSize);
+  file.close();
+
+  return buffer;
+}
+
+void V8_ShaderLoader::Preload(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_.contains(path))
+    return;
+
+  pending_.emplace(path, std::async(std::launch::async, ReadFile, path));
+}
+
+std::vector<char> V8_ShaderLoader::Get(const std::string& path) {
+  std::future<std::vector<char>> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(path);
+    if (it != pending_.end()) {
+      pending = std::move(it->second);
+      pending_.erase(it);
+    }
+  }
+
+  if (pending.valid())
+    return pending.get();
+
+  return ReadFile(path);
+}
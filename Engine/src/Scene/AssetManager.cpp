@@ -0,0 +1,350 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Assets
+
+#include <Scene/AssetManager.h>
+#include <Scene/Camera.h>
+#include <Core/FrameAllocator.h>
+#include <Core/MemoryTracker.h>
+#include <Core/PoolAllocator.h>
+#include <Core/Profiler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Loaded results waiting for upload are capped so I/O can't outrun the upload budget
+  constexpr size_t maxCompleted = 32;
+
+  // Frames to wait before requeuing a mesh that was evicted or didn't fit the budget
+  constexpr uint64_t retryDelay = 60;
+
+  uint64_t GpuBytes(uint64_t vertexCount, uint64_t indexCount, uint64_t meshletCount) {
+    return vertexCount * sizeof(V8_Vertex) + indexCount * sizeof(uint32_t) + meshletCount * (sizeof(V8_Meshlet) + sizeof(VkDrawIndexedIndirectCommand));
+  }
+}
+
+// Heap order for queue_, the top is the closest request
+bool V8_AssetManager::NearestFirst(const LoadRequest& a, const LoadRequest& b) {
+  return a.distance > b.distance;
+}
+
+V8_StaticMesh* V8_MeshHandle::Get() const {
+  return manager != nullptr ? manager->GetMesh(id) : nullptr;
+}
+
+V8_AssetManager::~V8_AssetManager() {
+  Shutdown();
+}
+
+void V8_AssetManager::Init(V8_Context& context) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  context_ = &context;
+  budget_ = context.config_.assetMemoryBudget;
+  uploadBytesPerFrame_ = context.config_.assetUploadBytesPerFrame;
+  stopping_ = false;
+
+  uint32_t threadCount = std::max(1u, context.config_.assetIOThreads);
+  for (uint32_t i = 0; i < threadCount; i++)
+    ioThreads_.emplace_back(&V8_AssetManager::IOLoop, this);
+}
+
+void V8_AssetManager::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+  }
+
+  queueCondition_.notify_all();
+  for (auto& thread : ioThreads_) {
+    if (thread.joinable())
+      thread.join();
+  }
+
+  ioThreads_.clear();
+  completed_.clear();
+
+  if (context_ != nullptr && context_->device_ != VK_NULL_HANDLE)
+    vkDeviceWaitIdle(context_->device_);
+
+  retired_.clear();
+  assets_.clear();
+  stats_ = {};
+}
+
+V8_MeshHandle V8_AssetManager::RequestMesh(const std::string& path, const Vector3& position, const Vector3& rotation, const Vector3& scale) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  MeshAsset& asset = assets_.emplace_back();
+  asset.path = path;
+  asset.position = position;
+  asset.rotation = rotation;
+  asset.scale = scale;
+  asset.requested = true;
+
+  return { this, static_cast<V8_AssetID>(assets_.size() - 1) };
+}
+
+V8_MeshHandle V8_AssetManager::RequestMesh(V8_MeshLoader loader, const Vector3& position, const Vector3& rotation, const Vector3& scale) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  MeshAsset& asset = assets_.emplace_back();
+  asset.loader = std::move(loader);
+  asset.position = position;
+  asset.rotation = rotation;
+  asset.scale = scale;
+  asset.requested = true;
+
+  return { this, static_cast<V8_AssetID>(assets_.size() - 1) };
+}
+
+void V8_AssetManager::Release(V8_MeshHandle handle) {
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  if (handle.manager != this || handle.id >= assets_.size())
+    return;
+
+  MeshAsset& asset = assets_[handle.id];
+  asset.requested = false;
+
+  if (asset.state == V8_AssetState::Resident)
+    Evict(handle.id);
+
+  if (asset.state == V8_AssetState::Queued) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::erase_if(queue_, [&](const LoadRequest& request) { return request.id == handle.id; });
+    std::make_heap(queue_.begin(), queue_.end(), NearestFirst);
+  }
+
+  // In-flight loads are dropped when their result arrives
+  asset.state = V8_AssetState::Unloaded;
+  asset.loader = nullptr;
+}
+
+V8_StaticMesh* V8_AssetManager::GetMesh(V8_AssetID id) const {
+  if (id >= assets_.size() || assets_[id].state != V8_AssetState::Resident)
+    return nullptr;
+
+  return assets_[id].mesh.get();
+}
+
+V8_AssetState V8_AssetManager::GetState(V8_AssetID id) const {
+  return id < assets_.size() ? assets_[id].state : V8_AssetState::Unloaded;
+}
+
+void V8_AssetManager::Update() {
+  V_PROFILE_FUNCTION();
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  frame_++;
+
+  // A retired mesh may still be referenced by every frame in flight
+  uint64_t framesInFlight = context_->swapchainImages_.size();
+  std::erase_if(retired_, [&](const RetiredMesh& retired) { return retired.frame + framesInFlight < frame_; });
+
+  UpdatePriorities();
+  ProcessCompleted();
+  QueueRequests();
+}
+
+void V8_AssetManager::UpdatePriorities() {
+  Vector3 viewer = camera_ != nullptr ? camera_->position : Vector3(0.0f);
+
+  for (auto& asset : assets_) {
+    if (asset.requested)
+      asset.distance = std::max(0.0f, glm::length(asset.position - viewer) - asset.radius);
+  }
+}
+
+void V8_AssetManager::ProcessCompleted() {
+  std::vector<LoadResult> results;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    results.swap(completed_);
+  }
+
+  if (results.empty())
+    return;
+
+  std::sort(results.begin(), results.end(), [&](const LoadResult& a, const LoadResult& b) {
+    return assets_[a.id].distance < assets_[b.id].distance;
+  });
+
+  uint64_t uploaded = 0;
+  V8_FrameVector<LoadResult> deferred;
+
+  for (auto& result : results) {
+    MeshAsset& asset = assets_[result.id];
+
+    // Released while loading
+    if (!asset.requested || asset.state != V8_AssetState::Queued)
+      continue;
+
+    if (!result.ok) {
+      asset.state = V8_AssetState::Failed;
+      continue;
+    }
+
+    if (uploaded >= uploadBytesPerFrame_) {
+      deferred.push_back(std::move(result));
+      continue;
+    }
+
+    uint64_t bytes;
+    if (result.cache) {
+      const V8_MeshCacheHeader& header = result.cache->Header();
+      bytes = GpuBytes(header.vertexCount, header.indexCount, header.meshletCount);
+    } else {
+      bytes = GpuBytes(result.mesh->vertices.size(), result.mesh->indices.size(), result.mesh->meshlets.size());
+    }
+
+    if (!MakeRoom(bytes, asset.distance)) {
+      asset.state = V8_AssetState::Unloaded;
+      asset.retryFrame = frame_ + retryDelay;
+      continue;
+    }
+
+    std::shared_ptr<V8_StaticMesh> mesh = result.mesh ? result.mesh : V8_MakePooled<V8_StaticMesh>();
+    mesh->position = asset.position;
+    mesh->rotation = asset.rotation;
+    mesh->scale = asset.scale;
+
+    if (result.cache) {
+      mesh->InitFromCache(*context_, *result.cache);
+    } else {
+      mesh->Upload(*context_);
+
+      // Loader geometry is only needed again for a reload, which rebuilds it
+      mesh->vertices = {};
+      mesh->indices = {};
+    }
+
+    float maxScale = std::max(std::fabs(asset.scale.x), std::max(std::fabs(asset.scale.y), std::fabs(asset.scale.z)));
+    asset.radius = mesh->boundsRadius * maxScale;
+    asset.mesh = std::move(mesh);
+    asset.bytes = bytes;
+    asset.state = V8_AssetState::Resident;
+
+    stats_.residentBytes += bytes;
+    stats_.residentCount++;
+    stats_.loads++;
+    uploaded += bytes;
+  }
+
+  if (!deferred.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& result : deferred)
+      completed_.push_back(std::move(result));
+  }
+
+  queueCondition_.notify_all();
+}
+
+void V8_AssetManager::QueueRequests() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto& request : queue_)
+    request.distance = assets_[request.id].distance;
+
+  for (V8_AssetID id = 0; id < assets_.size(); id++) {
+    MeshAsset& asset = assets_[id];
+    if (!asset.requested || asset.state != V8_AssetState::Unloaded || asset.retryFrame > frame_)
+      continue;
+
+    asset.state = V8_AssetState::Queued;
+    queue_.push_back({ asset.distance, id, asset.path, asset.loader });
+  }
+
+  std::make_heap(queue_.begin(), queue_.end(), NearestFirst);
+  stats_.queuedCount = static_cast<uint32_t>(queue_.size());
+
+  queueCondition_.notify_all();
+}
+
+bool V8_AssetManager::MakeRoom(uint64_t bytes, float distance) {
+  while (stats_.residentBytes + bytes > budget_) {
+    V8_AssetID farthest = V8_INVALID_ASSET;
+
+    for (V8_AssetID id = 0; id < assets_.size(); id++) {
+      if (assets_[id].state == V8_AssetState::Resident && (farthest == V8_INVALID_ASSET || assets_[id].distance > assets_[farthest].distance))
+        farthest = id;
+    }
+
+    // Never evict something nearer than what we're trying to load
+    if (farthest == V8_INVALID_ASSET || assets_[farthest].distance <= distance)
+      return false;
+
+    Evict(farthest);
+  }
+
+  return true;
+}
+
+void V8_AssetManager::Evict(V8_AssetID id) {
+  MeshAsset& asset = assets_[id];
+
+  retired_.push_back({ frame_, std::move(asset.mesh) });
+
+  stats_.residentBytes -= asset.bytes;
+  stats_.residentCount--;
+  stats_.evictions++;
+
+  asset.bytes = 0;
+  asset.state = V8_AssetState::Unloaded;
+  asset.retryFrame = frame_ + retryDelay;
+}
+
+void V8_AssetManager::IOLoop() {
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  profiler.SetThreadName("Asset IO");
+
+  while (true) {
+    LoadRequest request;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queueCondition_.wait(lock, [this] { return stopping_ || (!queue_.empty() && completed_.size() < maxCompleted); });
+
+      if (stopping_)
+        return;
+
+      std::pop_heap(queue_.begin(), queue_.end(), NearestFirst);
+      request = std::move(queue_.back());
+      queue_.pop_back();
+    }
+
+    V_PROFILE_SCOPE("Load mesh asset");
+
+    LoadResult result;
+    result.id = request.id;
+
+    if (request.loader) {
+      std::vector<V8_Vertex> vertices;
+      std::vector<uint32_t> indices;
+
+      if (request.loader(vertices, indices) && !indices.empty()) {
+        result.mesh = V8_MakePooled<V8_StaticMesh>();
+        result.mesh->Build(std::move(vertices), std::move(indices), true);
+        result.ok = true;
+      }
+    } else {
+      result.cache = std::make_unique<V8_MeshCacheFile>();
+      result.ok = result.cache->Open(request.path);
+
+      if (result.ok) {
+        // Fault the mapping in here so the upload on the main thread never waits on the disk
+        const volatile uint8_t* bytes = static_cast<const uint8_t*>(result.cache->Section(V8_MeshCacheSection::Vertices));
+        uint64_t size = result.cache->SectionSize(V8_MeshCacheSection::Vertices) + result.cache->SectionSize(V8_MeshCacheSection::Indices);
+        for (uint64_t offset = 0; offset < size; offset += 4096)
+          (void)bytes[offset];
+      }
+    }
+
+    if (!result.ok)
+      V_ERROR("Failed to load mesh asset {}", request.path.empty() ? std::to_string(request.id) : request.path);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_.push_back(std::move(result));
+  }
+}
@@ -0,0 +1,893 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Scene
+
+#include <Scene/Importer.h>
+#include <Core/MemoryTracker.h>
+#include <Core/PoolAllocator.h>
+#include <Core/ThreadPool.h>
+#include <Core/Profiler.h>
+#include <Core/Json.h>
+
+#include <glm/gtc/quaternion.hpp>
+#include <condition_variable>
+#include <unordered_map>
+#include <filesystem>
+#include <functional>
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <fstream>
+#include <numeric>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+namespace {
+  // A mesh decoded and built on a worker, then uploaded on the importing thread.
+  // Each instance is an entity and world transform that should display it.
+  struct MeshJob {
+    std::function<bool(std::vector<V8_Vertex>&, std::vector<uint32_t>&)> decode;
+    std::vector<std::pair<V8_Entity, Matrix4>> instances;
+    std::shared_ptr<V8_StaticMesh> mesh;
+    bool ok = false;
+  };
+
+  bool ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+      return false;
+
+    out.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(out.data()), out.size());
+
+    return file.good();
+  }
+
+  V8_Entity CreateNode(V8_Scene& scene, std::string name, V8_Entity parent, const Matrix4& local) {
+    V8_Entity entity = scene.registry.CreateEntity();
+
+    std::shared_ptr<V8_SceneNode> node = V8_MakePooled<V8_SceneNode>();
+    node->name = std::move(name);
+    node->parent = parent;
+    node->localTransform = local;
+    node->worldTransform = local;
+
+    if (V8_SceneNode* parentNode = scene.registry.GetComponent<V8_SceneNode>(parent)) {
+      node->worldTransform = parentNode->worldTransform * local;
+      parentNode->children.push_back(entity);
+    }
+
+    scene.registry.AddComponent<V8_SceneNode>(entity, node);
+    return entity;
+  }
+
+  // Meshes carry their own transform, decompose into the Z, Y, X Euler order GetModelMatrix uses
+  void ApplyTransform(V8_StaticMesh& mesh, const Matrix4& m) {
+    Vector3 axes[3] = { Vector3(m[0]), Vector3(m[1]), Vector3(m[2]) };
+
+    mesh.position = Vector3(m[3]);
+    mesh.scale = Vector3(glm::length(axes[0]), glm::length(axes[1]), glm::length(axes[2]));
+
+    // Mirrored nodes fold the reflection into the x scale
+    if (glm::dot(glm::cross(axes[0], axes[1]), axes[2]) < 0.0f)
+      mesh.scale.x = -mesh.scale.x;
+
+    for (int i = 0; i < 3; i++) {
+      if (mesh.scale[i] != 0.0f)
+        axes[i] /= mesh.scale[i];
+    }
+
+    mesh.rotation.x = std::atan2(axes[1].z, axes[2].z);
+    mesh.rotation.y = std::asin(-std::clamp(axes[0].z, -1.0f, 1.0f));
+    mesh.rotation.z = std::atan2(axes[0].y, axes[0].x);
+  }
+
+  void GenerateNormals(std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    for (auto& v : vertices)
+      v.normal = Vector3(0.0f);
+
+    // Unnormalized cross products weight each face by its area
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+      V8_Vertex& a = vertices[indices[i + 0]];
+      V8_Vertex& b = vertices[indices[i + 1]];
+      V8_Vertex& c = vertices[indices[i + 2]];
+
+      Vector3 normal = glm::cross(b.position - a.position, c.position - a.position);
+      a.normal += normal;
+      b.normal += normal;
+      c.normal += normal;
+    }
+
+    for (auto& v : vertices) {
+      float length = glm::length(v.normal);
+      v.normal = length > 0.0f ? v.normal / length : Vector3(0.0f, 0.0f, 1.0f);
+    }
+  }
+
+  // Runs every instanced job on the pool and uploads each mesh the moment its build finishes,
+  // so GPU transfers overlap with the remaining CPU work. Returns the number of meshes uploaded.
+  uint32_t BuildAndUpload(V8_Context& context, V8_Scene& scene, V8_ThreadPool& pool, std::vector<MeshJob>& jobs, bool generateLODs) {
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+    std::vector<size_t> finished;
+    size_t pending = 0;
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+      if (jobs[i].instances.empty())
+        continue;
+
+      pending++;
+      pool.Submit([&, i] {
+        V_PROFILE_SCOPE("Decode and build mesh");
+        V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+        MeshJob& job = jobs[i];
+        std::vector<V8_Vertex> vertices;
+        std::vector<uint32_t> indices;
+
+        job.ok = job.decode(vertices, indices) && !indices.empty();
+        if (job.ok) {
+          job.mesh = V8_MakePooled<V8_StaticMesh>();
+          job.mesh->Build(std::move(vertices), std::move(indices), generateLODs);
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          finished.push_back(i);
+        }
+
+        finishedCondition.notify_one();
+      });
+    }
+
+    uint32_t uploaded = 0;
+    std::vector<size_t> ready;
+
+    while (pending > 0) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        finishedCondition.wait(lock, [&] { return !finished.empty(); });
+        ready.swap(finished);
+      }
+
+      for (size_t i : ready) {
+        MeshJob& job = jobs[i];
+        pending--;
+
+        if (!job.ok)
+          continue;
+
+        for (size_t k = 0; k < job.instances.size(); k++) {
+          std::shared_ptr<V8_StaticMesh> mesh = job.mesh;
+
+          // The transform lives on the mesh, so further instances need their own copy
+          if (k > 0) {
+            mesh = V8_MakePooled<V8_StaticMesh>();
+            mesh->vertices = job.mesh->vertices;
+            mesh->indices = job.mesh->indices;
+            mesh->lods = job.mesh->lods;
+            mesh->meshlets = job.mesh->meshlets;
+            mesh->boundsCenter = job.mesh->boundsCenter;
+            mesh->boundsRadius = job.mesh->boundsRadius;
+          }
+
+          ApplyTransform(*mesh, job.instances[k].second);
+          mesh->Upload(context);
+          scene.registry.AddComponent<V8_StaticMesh>(job.instances[k].first, mesh);
+          uploaded++;
+        }
+      }
+
+      ready.clear();
+    }
+
+    return uploaded;
+  }
+
+  namespace gltf {
+    constexpr uint32_t glbMagic = 0x46546C67;     // "glTF"
+    constexpr uint32_t glbChunkJson = 0x4E4F534A; // "JSON"
+    constexpr uint32_t glbChunkBin = 0x004E4942;  // "BIN\0"
+
+    enum ComponentType : int64_t {
+      Byte = 5120,
+      UnsignedByte = 5121,
+      Short = 5122,
+      UnsignedShort = 5123,
+      UnsignedInt = 5125,
+      Float = 5126
+    };
+
+    enum PrimitiveMode : int64_t {
+      Triangles = 4,
+      TriangleStrip = 5,
+      TriangleFan = 6
+    };
+
+    struct Asset {
+      V8_JsonValue json;
+      std::vector<std::vector<uint8_t>> buffers;
+    };
+
+    // Typed window over a buffer view. data is null for accessors without a
+    // buffer view, which the spec defines as all zeros.
+    struct Accessor {
+      const uint8_t* data = nullptr;
+      size_t count = 0;
+      size_t stride = 0;
+      uint32_t components = 0;
+      int64_t componentType = 0;
+      bool normalized = false;
+    };
+
+    uint32_t ComponentCount(std::string_view type) {
+      if (type == "SCALAR") return 1;
+      if (type == "VEC2") return 2;
+      if (type == "VEC3") return 3;
+      if (type == "VEC4") return 4;
+      if (type == "MAT4") return 16;
+      return 0;
+    }
+
+    uint32_t ComponentSize(int64_t componentType) {
+      switch (componentType) {
+        case Byte: case UnsignedByte: return 1;
+        case Short: case UnsignedShort: return 2;
+        case UnsignedInt: case Float: return 4;
+        default: return 0;
+      }
+    }
+
+    bool ResolveAccessor(const Asset& asset, int64_t index, Accessor& out) {
+      const V8_JsonValue& accessor = asset.json["accessors"][static_cast<size_t>(std::max<int64_t>(index, 0))];
+      if (index < 0 || !accessor.IsObject())
+        return false;
+
+      if (accessor.Has("sparse")) {
+        V_WARNING("Sparse accessor {} is not supported", index);
+        return false;
+      }
+
+      int64_t count = accessor["count"].AsInt(-1);
+      out.components = ComponentCount(accessor["type"].AsString());
+      out.componentType = accessor["componentType"].AsInt();
+      out.normalized = accessor["normalized"].AsBool();
+
+      uint32_t componentSize = ComponentSize(out.componentType);
+      if (count < 0 || out.components == 0 || componentSize == 0)
+        return false;
+
+      out.count = static_cast<size_t>(count);
+      size_t elementSize = out.components * componentSize;
+
+      if (!accessor.Has("bufferView")) {
+        out.data = nullptr;
+        out.stride = 0;
+        return true;
+      }
+
+      int64_t viewIndex = accessor["bufferView"].AsInt(-1);
+      const V8_JsonValue& view = asset.json["bufferViews"][static_cast<size_t>(std::max<int64_t>(viewIndex, 0))];
+      int64_t bufferIndex = view["buffer"].AsInt(-1);
+      if (viewIndex < 0 || !view.IsObject() || bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= asset.buffers.size())
+        return false;
+
+      const std::vector<uint8_t>& buffer = asset.buffers[bufferIndex];
+      int64_t viewOffset = view["byteOffset"].AsInt(0);
+      int64_t viewLength = view["byteLength"].AsInt(-1);
+      int64_t accessorOffset = accessor["byteOffset"].AsInt(0);
+      int64_t stride = view["byteStride"].AsInt(0);
+
+      if (viewOffset < 0 || viewLength < 0 || accessorOffset < 0 || stride < 0)
+        return false;
+
+      // Only subtractions and a division, offsets and counts from the file can be large enough to wrap
+      uint64_t length = static_cast<uint64_t>(viewLength);
+      if (static_cast<uint64_t>(viewOffset) > buffer.size() || length > buffer.size() - viewOffset || static_cast<uint64_t>(accessorOffset) > length)
+        return false;
+
+      out.stride = stride != 0 ? static_cast<size_t>(stride) : elementSize;
+      if (out.stride < elementSize)
+        return false;
+
+      if (out.count > 0) {
+        uint64_t available = length - accessorOffset;
+        if (elementSize > available || out.count - 1 > (available - elementSize) / out.stride)
+          return false;
+      }
+
+      out.data = buffer.data() + viewOffset + accessorOffset;
+      return true;
+    }
+
+    float ReadFloat(const Accessor& accessor, size_t element, uint32_t component) {
+      if (accessor.data == nullptr)
+        return 0.0f;
+
+      const uint8_t* p = accessor.data + element * accessor.stride + component * ComponentSize(accessor.componentType);
+
+      switch (accessor.componentType) {
+        case Float: { float v; std::memcpy(&v, p, sizeof(v)); return v; }
+        case Byte: { int8_t v; std::memcpy(&v, p, sizeof(v)); return accessor.normalized ? std::max(v / 127.0f, -1.0f) : v; }
+        case UnsignedByte: { uint8_t v; std::memcpy(&v, p, sizeof(v)); return accessor.normalized ? v / 255.0f : v; }
+        case Short: { int16_t v; std::memcpy(&v, p, sizeof(v)); return accessor.normalized ? std::max(v / 32767.0f, -1.0f) : v; }
+        case UnsignedShort: { uint16_t v; std::memcpy(&v, p, sizeof(v)); return accessor.normalized ? v / 65535.0f : v; }
+        case UnsignedInt: { uint32_t v; std::memcpy(&v, p, sizeof(v)); return static_cast<float>(v); }
+        default: return 0.0f;
+      }
+    }
+
+    uint32_t ReadIndex(const Accessor& accessor, size_t element) {
+      if (accessor.data == nullptr)
+        return 0;
+
+      const uint8_t* p = accessor.data + element * accessor.stride;
+
+      switch (accessor.componentType) {
+        case UnsignedByte: return *p;
+        case UnsignedShort: { uint16_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+        case UnsignedInt: { uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+        default: return UINT32_MAX;
+      }
+    }
+
+    bool DecodeBase64(std::string_view text, std::vector<uint8_t>& out) {
+      auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+      };
+
+      out.clear();
+      out.reserve(text.size() / 4 * 3);
+
+      uint32_t accumulator = 0;
+      int bits = 0;
+
+      for (char c : text) {
+        if (c == '=')
+          break;
+
+        int v = value(c);
+        if (v < 0)
+          return false;
+
+        accumulator = (accumulator << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+
+        if (bits >= 8) {
+          bits -= 8;
+          out.push_back(static_cast<uint8_t>((accumulator >> bits) & 0xFF));
+        }
+      }
+
+      return true;
+    }
+
+    std::string DecodeUri(std::string_view uri) {
+      std::string out;
+      out.reserve(uri.size());
+
+      for (size_t i = 0; i < uri.size(); i++) {
+        uint32_t byte;
+        if (uri[i] == '%' && i + 2 < uri.size() && std::from_chars(uri.data() + i + 1, uri.data() + i + 3, byte, 16).ptr == uri.data() + i + 3) {
+          out += static_cast<char>(byte);
+          i += 2;
+        } else {
+          out += uri[i];
+        }
+      }
+
+      return out;
+    }
+
+    bool Load(const std::filesystem::path& path, V8_ThreadPool& pool, Asset& asset) {
+      std::vector<uint8_t> file;
+      if (!ReadFile(path, file)) {
+        V_ERROR("Failed to open file {}", path.string());
+        return false;
+      }
+
+      std::string_view jsonText(reinterpret_cast<const char*>(file.data()), file.size());
+      std::vector<uint8_t> binChunk;
+      bool hasBinChunk = false;
+
+      uint32_t magic = 0;
+      if (file.size() >= 4)
+        std::memcpy(&magic, file.data(), sizeof(magic));
+
+      if (magic == glbMagic) {
+        // 12 byte header followed by a JSON chunk and an optional BIN chunk
+        size_t offset = 12;
+        jsonText = {};
+
+        while (offset + 8 <= file.size()) {
+          uint32_t chunkLength, chunkType;
+          std::memcpy(&chunkLength, file.data() + offset, sizeof(chunkLength));
+          std::memcpy(&chunkType, file.data() + offset + 4, sizeof(chunkType));
+          offset += 8;
+
+          if (offset + chunkLength > file.size()) {
+            V_ERROR("{} has a truncated chunk", path.string());
+            return false;
+          }
+
+          if (chunkType == glbChunkJson && jsonText.empty()) {
+            jsonText = std::string_view(reinterpret_cast<const char*>(file.data() + offset), chunkLength);
+          } else if (chunkType == glbChunkBin && !hasBinChunk) {
+            binChunk.assign(file.begin() + offset, file.begin() + offset + chunkLength);
+            hasBinChunk = true;
+          }
+
+          offset += (chunkLength + 3) & ~3u;
+        }
+      }
+
+      std::string error;
+      if (!V8_ParseJson(jsonText, asset.json, &error)) {
+        V_ERROR("Failed to parse {}: {}", path.string(), error);
+        return false;
+      }
+
+      if (!asset.json["asset"]["version"].AsString().starts_with("2")) {
+        V_ERROR("{} is not a glTF 2.0 asset", path.string());
+        return false;
+      }
+
+      const V8_JsonValue& buffers = asset.json["buffers"];
+      asset.buffers.resize(buffers.Size());
+
+      std::atomic<bool> failed = false;
+      std::filesystem::path directory = path.parent_path();
+
+      for (size_t i = 0; i < buffers.Size(); i++) {
+        const V8_JsonValue& buffer = buffers[i];
+
+        if (!buffer.Has("uri")) {
+          if (i == 0 && hasBinChunk) {
+            asset.buffers[0] = std::move(binChunk);
+          } else {
+            V_ERROR("Buffer {} of {} has no data", i, path.string());
+            failed = true;
+          }
+
+          continue;
+        }
+
+        // External files and data URIs are read and decoded in parallel
+        pool.Submit([&, i] {
+          V_PROFILE_SCOPE("Load glTF buffer");
+          V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+          std::string_view uri = buffers[i]["uri"].AsString();
+          std::vector<uint8_t>& data = asset.buffers[i];
+          bool ok;
+
+          if (uri.starts_with("data:")) {
+            size_t comma = uri.find(";base64,");
+            ok = comma != std::string_view::npos && DecodeBase64(uri.substr(comma + 8), data);
+          } else {
+            ok = ReadFile(directory / DecodeUri(uri), data);
+          }
+
+          if (!ok || data.size() < static_cast<size_t>(buffers[i]["byteLength"].AsInt(0))) {
+            V_ERROR("Failed to load buffer {} of {}", i, path.string());
+            failed = true;
+          }
+        });
+      }
+
+      pool.WaitIdle();
+      return !failed;
+    }
+
+    Matrix4 NodeTransform(const V8_JsonValue& node) {
+      const V8_JsonValue& matrix = node["matrix"];
+      if (matrix.Size() == 16) {
+        Matrix4 m(1.0f);
+        for (int c = 0; c < 4; c++) {
+          for (int r = 0; r < 4; r++)
+            m[c][r] = static_cast<float>(matrix[c * 4 + r].AsNumber());
+        }
+
+        return m;
+      }
+
+      const V8_JsonValue& t = node["translation"];
+      const V8_JsonValue& r = node["rotation"];
+      const V8_JsonValue& s = node["scale"];
+
+      Vector3 translation(t[0].AsNumber(0.0), t[1].AsNumber(0.0), t[2].AsNumber(0.0));
+      glm::quat rotation(static_cast<float>(r[3].AsNumber(1.0)), static_cast<float>(r[0].AsNumber(0.0)), static_cast<float>(r[1].AsNumber(0.0)), static_cast<float>(r[2].AsNumber(0.0)));
+      Vector3 scale(s[0].AsNumber(1.0), s[1].AsNumber(1.0), s[2].AsNumber(1.0));
+
+      return glm::translate(Matrix4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(Matrix4(1.0f), scale);
+    }
+
+    bool DecodePrimitive(const Asset& asset, const V8_JsonValue& primitive, std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+      const V8_JsonValue& attributes = primitive["attributes"];
+
+      Accessor positions;
+      if (!ResolveAccessor(asset, attributes["POSITION"].AsInt(-1), positions) || positions.components != 3)
+        return false;
+
+      vertices.resize(positions.count);
+      for (size_t i = 0; i < positions.count; i++) {
+        vertices[i].position = Vector3(ReadFloat(positions, i, 0), ReadFloat(positions, i, 1), ReadFloat(positions, i, 2));
+        vertices[i].normal = Vector3(0.0f);
+        vertices[i].color = Vector3(1.0f);
+        vertices[i].uv = Vector2(0.0f);
+      }
+
+      Accessor normals;
+      bool hasNormals = ResolveAccessor(asset, attributes["NORMAL"].AsInt(-1), normals) && normals.components == 3 && normals.count == positions.count;
+      if (hasNormals) {
+        for (size_t i = 0; i < normals.count; i++)
+          vertices[i].normal = Vector3(ReadFloat(normals, i, 0), ReadFloat(normals, i, 1), ReadFloat(normals, i, 2));
+      }
+
+      Accessor uvs;
+      if (ResolveAccessor(asset, attributes["TEXCOORD_0"].AsInt(-1), uvs) && uvs.components == 2 && uvs.count == positions.count) {
+        for (size_t i = 0; i < uvs.count; i++)
+          vertices[i].uv = Vector2(ReadFloat(uvs, i, 0), ReadFloat(uvs, i, 1));
+      }
+
+      Accessor colors;
+      if (ResolveAccessor(asset, attributes["COLOR_0"].AsInt(-1), colors) && colors.components >= 3 && colors.components <= 4 && colors.count == positions.count) {
+        for (size_t i = 0; i < colors.count; i++)
+          vertices[i].color = Vector3(ReadFloat(colors, i, 0), ReadFloat(colors, i, 1), ReadFloat(colors, i, 2));
+      }
+
+      std::vector<uint32_t> source;
+      if (primitive.Has("indices")) {
+        Accessor indexAccessor;
+        if (!ResolveAccessor(asset, primitive["indices"].AsInt(-1), indexAccessor) || indexAccessor.components != 1)
+          return false;
+
+        source.resize(indexAccessor.count);
+        for (size_t i = 0; i < indexAccessor.count; i++) {
+          source[i] = ReadIndex(indexAccessor, i);
+          if (source[i] >= vertices.size())
+            return false;
+        }
+      } else {
+        source.resize(vertices.size());
+        std::iota(source.begin(), source.end(), 0u);
+      }
+
+      int64_t mode = primitive["mode"].AsInt(Triangles);
+      if (mode == Triangles) {
+        source.resize(source.size() / 3 * 3);
+        indices = std::move(source);
+      } else if (mode == TriangleStrip) {
+        for (size_t i = 2; i < source.size(); i++) {
+          bool even = (i % 2) == 0;
+          indices.insert(indices.end(), { source[even ? i - 2 : i - 1], source[even ? i - 1 : i - 2], source[i] });
+        }
+      } else if (mode == TriangleFan) {
+        for (size_t i = 2; i < source.size(); i++)
+          indices.insert(indices.end(), { source[0], source[i - 1], source[i] });
+      } else {
+        V_WARNING("Skipping primitive with unsupported mode {}", mode);
+        return false;
+      }
+
+      if (!hasNormals)
+        GenerateNormals(vertices, indices);
+
+      return true;
+    }
+
+    V8_Entity Import(V8_Context& context, V8_Scene& scene, const std::filesystem::path& path, const V8_ImportOptions& options, uint32_t& nodeCount, uint32_t& meshCount) {
+      V8_ThreadPool pool(options.workerCount);
+
+      Asset asset;
+      if (!Load(path, pool, asset))
+        return V8_INVALID_ENTITY;
+
+      const V8_JsonValue& nodes = asset.json["nodes"];
+      const V8_JsonValue& meshes = asset.json["meshes"];
+
+      // One job per primitive, the primitives of mesh m start at firstJob[m]
+      std::vector<MeshJob> jobs;
+      std::vector<size_t> firstJob(meshes.Size() + 1, 0);
+
+      for (size_t m = 0; m < meshes.Size(); m++) {
+        firstJob[m] = jobs.size();
+
+        const V8_JsonValue& primitives = meshes[m]["primitives"];
+        for (size_t p = 0; p < primitives.Size(); p++) {
+          const V8_JsonValue& primitive = primitives[p];
+          jobs.emplace_back().decode = [&asset, &primitive](std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+            return DecodePrimitive(asset, primitive, vertices, indices);
+          };
+        }
+      }
+
+      firstJob[meshes.Size()] = jobs.size();
+
+      V8_Entity root = CreateNode(scene, path.stem().string(), V8_INVALID_ENTITY, Matrix4(1.0f));
+
+      // Depth first walk of the default scene; only meshes reachable from it are built
+      std::vector<std::pair<int64_t, V8_Entity>> stack;
+      std::vector<bool> visited(nodes.Size(), false);
+
+      const V8_JsonValue& roots = asset.json["scenes"][static_cast<size_t>(asset.json["scene"].AsInt(0))]["nodes"];
+      for (size_t i = roots.Size(); i-- > 0;)
+        stack.push_back({ roots[i].AsInt(-1), root });
+
+      while (!stack.empty()) {
+        auto [index, parent] = stack.back();
+        stack.pop_back();
+
+        if (index < 0 || static_cast<size_t>(index) >= nodes.Size() || visited[index]) {
+          V_WARNING("{} references invalid or repeated node {}", path.string(), index);
+          continue;
+        }
+
+        visited[index] = true;
+        nodeCount++;
+
+        const V8_JsonValue& node = nodes[index];
+        std::string name(node["name"].AsString());
+        if (name.empty())
+          name = "node" + std::to_string(index);
+
+        V8_Entity entity = CreateNode(scene, name, parent, NodeTransform(node));
+        const Matrix4& world = scene.registry.GetComponent<V8_SceneNode>(entity)->worldTransform;
+
+        int64_t mesh = node["mesh"].AsInt(-1);
+        if (mesh >= 0 && static_cast<size_t>(mesh) < meshes.Size()) {
+          // An entity holds one mesh, extra primitives become child entities
+          for (size_t job = firstJob[mesh]; job < firstJob[mesh + 1]; job++) {
+            V8_Entity target = entity;
+            if (job != firstJob[mesh])
+              target = CreateNode(scene, name + "." + std::to_string(job - firstJob[mesh]), entity, Matrix4(1.0f));
+
+            jobs[job].instances.push_back({ target, world });
+          }
+        }
+
+        const V8_JsonValue& children = node["children"];
+        for (size_t i = children.Size(); i-- > 0;)
+          stack.push_back({ children[i].AsInt(-1), entity });
+      }
+
+      meshCount = BuildAndUpload(context, scene, pool, jobs, options.generateLODs);
+      return root;
+    }
+  }
+
+  namespace obj {
+    struct Corner {
+      int64_t position;
+      int64_t uv;
+      int64_t normal;
+
+      bool operator==(const Corner& other) const {
+        return position == other.position && uv == other.uv && normal == other.normal;
+      }
+    };
+
+    struct CornerHash {
+      size_t operator()(const Corner& c) const {
+        return std::hash<int64_t>()(c.position) ^ (std::hash<int64_t>()(c.uv) * 31) ^ (std::hash<int64_t>()(c.normal) * 131);
+      }
+    };
+
+    struct Group {
+      std::string name;
+      std::vector<Corner> corners; // three per triangle
+    };
+
+    struct Data {
+      std::vector<Vector3> positions;
+      std::vector<Vector3> colors;
+      std::vector<Vector2> uvs;
+      std::vector<Vector3> normals;
+      std::vector<Group> groups;
+    };
+
+    std::string_view NextToken(std::string_view& line) {
+      size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string_view::npos) {
+        line = {};
+        return {};
+      }
+
+      size_t end = line.find_first_of(" \t\r", start);
+      if (end == std::string_view::npos)
+        end = line.size();
+
+      std::string_view token = line.substr(start, end - start);
+      line.remove_prefix(end);
+      return token;
+    }
+
+    float ParseFloat(std::string_view token) {
+      float value = 0.0f;
+      std::from_chars(token.data(), token.data() + token.size(), value);
+      return value;
+    }
+
+    // OBJ indices are 1-based, negative values count back from the newest element
+    int64_t ResolveIndex(std::string_view token, size_t count) {
+      int64_t value = 0;
+      if (token.empty() || std::from_chars(token.data(), token.data() + token.size(), value).ec != std::errc())
+        return -1;
+
+      return value < 0 ? static_cast<int64_t>(count) + value : value - 1;
+    }
+
+    bool Parse(std::string_view text, Data& data) {
+      data.groups.emplace_back();
+
+      std::vector<Corner> face;
+
+      while (!text.empty()) {
+        size_t lineEnd = text.find('\n');
+        std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        std::string_view keyword = NextToken(line);
+
+        if (keyword == "v") {
+          Vector3 p;
+          for (int i = 0; i < 3; i++)
+            p[i] = ParseFloat(NextToken(line));
+          data.positions.push_back(p);
+
+          // Vertex colors are a common extension: v x y z r g b
+          std::string_view r = NextToken(line);
+          if (!r.empty()) {
+            data.colors.resize(data.positions.size() - 1, Vector3(1.0f));
+            data.colors.push_back(Vector3(ParseFloat(r), ParseFloat(NextToken(line)), ParseFloat(NextToken(line))));
+          }
+        } else if (keyword == "vt") {
+          float u = ParseFloat(NextToken(line));
+          float v = ParseFloat(NextToken(line));
+          data.uvs.push_back(Vector2(u, 1.0f - v));
+        } else if (keyword == "vn") {
+          Vector3 n;
+          for (int i = 0; i < 3; i++)
+            n[i] = ParseFloat(NextToken(line));
+          data.normals.push_back(n);
+        } else if (keyword == "f") {
+          face.clear();
+
+          for (std::string_view token = NextToken(line); !token.empty(); token = NextToken(line)) {
+            size_t slash0 = token.find('/');
+            size_t slash1 = slash0 == std::string_view::npos ? std::string_view::npos : token.find('/', slash0 + 1);
+
+            Corner corner;
+            corner.position = ResolveIndex(token.substr(0, slash0), data.positions.size());
+            corner.uv = slash0 == std::string_view::npos ? -1 : ResolveIndex(token.substr(slash0 + 1, slash1 - slash0 - 1), data.uvs.size());
+            corner.normal = slash1 == std::string_view::npos ? -1 : ResolveIndex(token.substr(slash1 + 1), data.normals.size());
+
+            if (corner.position < 0)
+              return false;
+
+            face.push_back(corner);
+          }
+
+          std::vector<Corner>& corners = data.groups.back().corners;
+          for (size_t i = 2; i < face.size(); i++)
+            corners.insert(corners.end(), { face[0], face[i - 1], face[i] });
+        } else if (keyword == "o" || keyword == "g") {
+          if (!data.groups.back().corners.empty())
+            data.groups.emplace_back();
+
+          data.groups.back().name = std::string(NextToken(line));
+        }
+      }
+
+      if (!data.colors.empty())
+        data.colors.resize(data.positions.size(), Vector3(1.0f));
+
+      std::erase_if(data.groups, [](const Group& group) { return group.corners.empty(); });
+      return true;
+    }
+
+    bool DecodeGroup(const Data& data, const Group& group, std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+      std::unordered_map<Corner, uint32_t, CornerHash> remap;
+      remap.reserve(group.corners.size());
+      indices.reserve(group.corners.size());
+
+      bool hasNormals = true;
+
+      for (const Corner& corner : group.corners) {
+        auto [it, inserted] = remap.try_emplace(corner, static_cast<uint32_t>(vertices.size()));
+        indices.push_back(it->second);
+
+        if (!inserted)
+          continue;
+
+        if (static_cast<size_t>(corner.position) >= data.positions.size() || corner.uv >= static_cast<int64_t>(data.uvs.size()) || corner.normal >= static_cast<int64_t>(data.normals.size()))
+          return false;
+
+        V8_Vertex vertex {};
+        vertex.position = data.positions[corner.position];
+        vertex.color = data.colors.empty() ? Vector3(1.0f) : data.colors[corner.position];
+        vertex.uv = corner.uv >= 0 ? data.uvs[corner.uv] : Vector2(0.0f);
+        vertex.normal = corner.normal >= 0 ? data.normals[corner.normal] : Vector3(0.0f);
+        hasNormals &= corner.normal >= 0;
+
+        vertices.push_back(vertex);
+      }
+
+      if (!hasNormals)
+        GenerateNormals(vertices, indices);
+
+      return true;
+    }
+
+    V8_Entity Import(V8_Context& context, V8_Scene& scene, const std::filesystem::path& path, const V8_ImportOptions& options, uint32_t& nodeCount, uint32_t& meshCount) {
+      std::vector<uint8_t> file;
+      if (!ReadFile(path, file)) {
+        V_ERROR("Failed to open file {}", path.string());
+        return V8_INVALID_ENTITY;
+      }
+
+      // Parsing is a single pass over the text; deduplication, LODs and meshlets run per group on the pool
+      Data data;
+      if (!Parse(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()), data)) {
+        V_ERROR("Failed to parse {}", path.string());
+        return V8_INVALID_ENTITY;
+      }
+
+      V8_ThreadPool pool(options.workerCount);
+      V8_Entity root = CreateNode(scene, path.stem().string(), V8_INVALID_ENTITY, Matrix4(1.0f));
+
+      std::vector<MeshJob> jobs(data.groups.size());
+      for (size_t i = 0; i < data.groups.size(); i++) {
+        const Group& group = data.groups[i];
+        std::string name = group.name.empty() ? "group" + std::to_string(i) : group.name;
+
+        jobs[i].instances.push_back({ CreateNode(scene, name, root, Matrix4(1.0f)), Matrix4(1.0f) });
+        jobs[i].decode = [&data, &group](std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+          return DecodeGroup(data, group, vertices, indices);
+        };
+      }
+
+      nodeCount = static_cast<uint32_t>(jobs.size());
+      meshCount = BuildAndUpload(context, scene, pool, jobs, options.generateLODs);
+      return root;
+    }
+  }
+}
+
+V8_Entity V8_ImportScene(V8_Context& context, V8_Scene& scene, const std::string& path, const V8_ImportOptions& options) {
+  V_PROFILE_FUNCTION();
+  V_MEMORY_SCOPE(V8_MemoryTag::Assets);
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::filesystem::path file(path);
+  std::string extension = file.extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+
+  uint32_t nodeCount = 0;
+  uint32_t meshCount = 0;
+  V8_Entity root = V8_INVALID_ENTITY;
+
+  if (extension == ".gltf" || extension == ".glb") {
+    root = gltf::Import(context, scene, file, options, nodeCount, meshCount);
+  } else if (extension == ".obj") {
+    root = obj::Import(context, scene, file, options, nodeCount, meshCount);
+  } else {
+    V_ERROR("Unsupported scene format {}", path);
+    return V8_INVALID_ENTITY;
+  }
+
+  if (root != V8_INVALID_ENTITY) {
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    V_INFO("Imported {}: {} nodes, {} meshes in {:.1f} ms", path, nodeCount, meshCount, ms);
+  }
+
+  return root;
+}
@@ -1,151 +1,227 @@
 #include <Scene/Types.h>
+#include <Scene/Camera.h>
+#include <Scene/Simplify.h>
+#include <Scene/Meshlet.h>
+#include <Scene/MeshCache.h>
+#include <Core/Profiler.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <cfloat>
+#include <cmath>
+
+static void CreateDeviceBuffer(V8_Context& context, VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VmaAllocation& allocation) {
+  VkBufferCreateInfo bufferInfo {};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = size;
+  bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo {};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+  VK_CHECK(vmaCreateBuffer(context.allocator_, &bufferInfo, &allocInfo, &buffer, &allocation, nullptr));
+}
 
-void V8_StaticMesh::Init(V8_Context& context, const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices) {
-  this->vertices = vertices;
-  this->indices = indices;
+void V8_StaticMesh::Init(V8_Context& context, const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, bool generateLODs) {
+  Build(vertices, indices, generateLODs);
+  Upload(context);
+}
 
-  VkBufferCreateInfo vertexBufferInfo {};
-  vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  vertexBufferInfo.size = vertices.size() * sizeof(V8_Vertex);
-  vertexBufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-  vertexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+void V8_StaticMesh::Build(std::vector<V8_Vertex> vertices, std::vector<uint32_t> indices, bool generateLODs) {
+  V_PROFILE_FUNCTION();
 
-  VmaAllocationCreateInfo vertexAllocInfo {};
-  vertexAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  this->vertices = std::move(vertices);
+  this->indices = std::move(indices);
 
-  VK_CHECK(vmaCreateBuffer(context.allocator_, &vertexBufferInfo, &vertexAllocInfo, &vertexBuffer, &vertexBufferAllocation, nullptr));
+  ComputeBounds();
 
-  VkBufferCreateInfo indexBufferInfo {};
-  indexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  indexBufferInfo.size = indices.size() * sizeof(uint32_t);
-  indexBufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-  indexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  lods.clear();
+  if (generateLODs) {
+    GenerateLODs();
+  } else {
+    lods.push_back({ 0, static_cast<uint32_t>(this->indices.size()), 0.0f });
+  }
 
-  VmaAllocationCreateInfo indexAllocInfo {};
-  indexAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  GenerateMeshlets();
+}
 
-  VK_CHECK(vmaCreateBuffer(context.allocator_, &indexBufferInfo, &indexAllocInfo, &indexBuffer, &indexBufferAllocation, nullptr));
+void V8_StaticMesh::Upload(V8_Context& context) {
+  V_PROFILE_FUNCTION();
+
+  CreateDeviceBuffer(context, vertices.size() * sizeof(V8_Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferAllocation);
+  CreateDeviceBuffer(context, indices.size() * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferAllocation);
+
+  if (!meshlets.empty())
+    CreateDeviceBuffer(context, meshlets.size() * sizeof(V8_Meshlet), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletBuffer, meshletBufferAllocation);
 
   allocator_ = &context.allocator_;
 
-  UploadVertexData(context);
-  UploadIndexData(context);
+  UploadData(context);
 }
 
-void V8_StaticMesh::UploadVertexData(V8_Context& context) {
-  VkBuffer stagingBuffer;
-  VmaAllocation stagingBufferAllocation;
+void V8_StaticMesh::InitFromCache(V8_Context& context, const V8_MeshCacheFile& cache) {
+  V_PROFILE_FUNCTION();
 
-  VkBufferCreateInfo bufferInfo {};
-  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  bufferInfo.size = vertices.size() * sizeof(V8_Vertex);
-  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  const V8_MeshCacheHeader& header = cache.Header();
 
-  VmaAllocationCreateInfo allocInfo {};
-  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+  // Geometry goes from the mapping straight into staging memory; only the small tables are kept on the CPU
+  vertices.clear();
+  indices.clear();
+
+  const V8_MeshLOD* cachedLods = static_cast<const V8_MeshLOD*>(cache.Section(V8_MeshCacheSection::LODs));
+  lods.assign(cachedLods, cachedLods + header.lodCount);
 
-  VK_CHECK(vmaCreateBuffer(context.allocator_, &bufferInfo, &allocInfo, &stagingBuffer, &stagingBufferAllocation, nullptr));
+  const V8_Meshlet* cachedMeshlets = static_cast<const V8_Meshlet*>(cache.Section(V8_MeshCacheSection::Meshlets));
+  meshlets.assign(cachedMeshlets, cachedMeshlets + header.meshletCount);
 
-  void* data;
-  vmaMapMemory(context.allocator_, stagingBufferAllocation, &data);
-  memcpy(data, vertices.data(), vertices.size() * sizeof(V8_Vertex));
-  vmaUnmapMemory(context.allocator_, stagingBufferAllocation);
+  if (lods.empty())
+    lods.push_back({ 0, header.indexCount, 0.0f });
 
-  VkCommandBuffer cmdBuffer;
+  boundsCenter = Vector3(header.boundsCenter[0], header.boundsCenter[1], header.boundsCenter[2]);
+  boundsRadius = header.boundsRadius;
 
-  VkCommandBufferAllocateInfo cmdBufferAllocInfo {};
-  cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  cmdBufferAllocInfo.commandPool = context.commandPools_[context.graphicsQueueFamilyIndex_];
-  cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  cmdBufferAllocInfo.commandBufferCount = 1;
+  VkDeviceSize vertexBytes = cache.SectionSize(V8_MeshCacheSection::Vertices);
+  VkDeviceSize indexBytes = cache.SectionSize(V8_MeshCacheSection::Indices);
 
-  VK_CHECK(vkAllocateCommandBuffers(context.device_, &cmdBufferAllocInfo, &cmdBuffer));
+  CreateDeviceBuffer(context, vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferAllocation);
+  CreateDeviceBuffer(context, indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferAllocation);
 
-  VkCommandBufferBeginInfo cmdBufferBeginInfo {};
-  cmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  cmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (!meshlets.empty())
+    CreateDeviceBuffer(context, meshlets.size() * sizeof(V8_Meshlet), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletBuffer, meshletBufferAllocation);
 
-  VK_CHECK(vkBeginCommandBuffer(cmdBuffer, &cmdBufferBeginInfo));
+  allocator_ = &context.allocator_;
 
-  VkBufferCopy copyRegion {};
-  copyRegion.srcOffset = 0;
-  copyRegion.dstOffset = 0;
-  copyRegion.size = vertices.size() * sizeof(V8_Vertex);
+  context.stagingRing_.Upload(vertexBuffer, 0, cache.Section(V8_MeshCacheSection::Vertices), vertexBytes);
+  context.stagingRing_.Upload(indexBuffer, 0, cache.Section(V8_MeshCacheSection::Indices), indexBytes);
+  UploadMeshletData(context);
 
-  vkCmdCopyBuffer(cmdBuffer, stagingBuffer, vertexBuffer, 1, &copyRegion);
+  context.stagingRing_.Submit();
+}
 
-  VK_CHECK(vkEndCommandBuffer(cmdBuffer));
+void V8_StaticMesh::ComputeBounds() {
+  boundsCenter = Vector3(0.0f);
+  boundsRadius = 0.0f;
 
-  VkSubmitInfo submitInfo {};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &cmdBuffer;
+  if (vertices.empty())
+    return;
 
-  VK_CHECK(vkQueueSubmit(context.graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE));
-  VK_CHECK(vkQueueWaitIdle(context.graphicsQueue_));
+  Vector3 minPos(FLT_MAX);
+  Vector3 maxPos(-FLT_MAX);
+  for (const auto& v : vertices) {
+    minPos = glm::min(minPos, v.position);
+    maxPos = glm::max(maxPos, v.position);
+  }
 
-  vmaDestroyBuffer(context.allocator_, stagingBuffer, stagingBufferAllocation);
-  vkFreeCommandBuffers(context.device_, context.commandPools_[context.graphicsQueueFamilyIndex_], 1, &cmdBuffer);
+  boundsCenter = (minPos + maxPos) * 0.5f;
+  for (const auto& v : vertices)
+    boundsRadius = std::max(boundsRadius, glm::length(v.position - boundsCenter));
 }
 
-void V8_StaticMesh::UploadIndexData(V8_Context& context) {
-  VkBuffer stagingBuffer;
-  VmaAllocation stagingBufferAllocation;
+void V8_StaticMesh::GenerateLODs(uint32_t maxLODs, float reduction) {
+  if (vertices.empty())
+    return;
 
-  VkBufferCreateInfo bufferInfo {};
-  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  bufferInfo.size = indices.size() * sizeof(uint32_t);
-  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  // Regenerating always starts from the full detail mesh
+  std::vector<uint32_t> current = indices;
+  if (!lods.empty())
+    current.assign(indices.begin() + lods[0].indexOffset, indices.begin() + lods[0].indexOffset + lods[0].indexCount);
 
-  VmaAllocationCreateInfo allocInfo {};
-  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+  std::vector<uint32_t> chain = current;
+
+  lods.clear();
+  lods.push_back({ 0, static_cast<uint32_t>(current.size()), 0.0f });
+
+  // Each level is simplified from the previous one, so errors accumulate down the chain
+  float error = 0.0f;
+  while (lods.size() < maxLODs) {
+    size_t targetIndexCount = static_cast<size_t>(current.size() / 3 * reduction) * 3;
+
+    float lodError = 0.0f;
+    std::vector<uint32_t> next = V8_SimplifyMesh(vertices, current, targetIndexCount, boundsRadius * 0.25f, &lodError);
 
-  VK_CHECK(vmaCreateBuffer(context.allocator_, &bufferInfo, &allocInfo, &stagingBuffer, &stagingBufferAllocation, nullptr));
+    // Stop once simplification stalls on locked borders/seams or the error budget
+    if (next.empty() || next.size() > current.size() * 9 / 10)
+      break;
 
-  void* data;
-  vmaMapMemory(context.allocator_, stagingBufferAllocation, &data);
-  memcpy(data, indices.data(), indices.size() * sizeof(uint32_t));
-  vmaUnmapMemory(context.allocator_, stagingBufferAllocation);
+    error += lodError;
+    lods.push_back({ static_cast<uint32_t>(chain.size()), static_cast<uint32_t>(next.size()), error });
+    chain.insert(chain.end(), next.begin(), next.end());
+    current = std::move(next);
+  }
+
+  indices = std::move(chain);
+}
 
-  VkCommandBuffer cmdBuffer;
+void V8_StaticMesh::GenerateMeshlets() {
+  if (lods.empty())
+    lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f });
 
-  VkCommandBufferAllocateInfo cmdBufferAllocInfo {};
-  cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  cmdBufferAllocInfo.commandPool = context.commandPools_[context.graphicsQueueFamilyIndex_];
-  cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  cmdBufferAllocInfo.commandBufferCount = 1;
+  meshlets = V8_BuildMeshlets(vertices, indices, lods[0].indexOffset, lods[0].indexCount);
+}
 
-  VK_CHECK(vkAllocateCommandBuffers(context.device_, &cmdBufferAllocInfo, &cmdBuffer));
+uint32_t V8_StaticMesh::SelectLOD(const V8_Camera& camera, float viewportHeight, float errorThreshold) const {
+  if (lods.size() <= 1)
+    return 0;
 
-  VkCommandBufferBeginInfo cmdBufferBeginInfo {};
-  cmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  cmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  Matrix4 model = GetModelMatrix();
+  Vector3 center = Vector3(model * glm::vec4(boundsCenter, 1.0f));
+  float maxScale = std::max(std::fabs(scale.x), std::max(std::fabs(scale.y), std::fabs(scale.z)));
 
-  VK_CHECK(vkBeginCommandBuffer(cmdBuffer, &cmdBufferBeginInfo));
+  float distance = glm::length(center - camera.position) - boundsRadius * maxScale;
+  distance = std::max(distance, camera.nearPlane);
 
-  VkBufferCopy copyRegion {};
-  copyRegion.srcOffset = 0;
-  copyRegion.dstOffset = 0;
-  copyRegion.size = indices.size() * sizeof(uint32_t);
+  // Screen-space pixels covered by one world unit at the closest point of the bounds
+  float pixelsPerUnit = viewportHeight / (2.0f * std::tan(glm::radians(camera.zoom) * 0.5f) * distance);
 
-  vkCmdCopyBuffer(cmdBuffer, stagingBuffer, indexBuffer, 1, &copyRegion);
+  uint32_t lod = 0;
+  for (uint32_t i = 1; i < lods.size(); i++) {
+    if (lods[i].error * maxScale * pixelsPerUnit > errorThreshold)
+      break;
 
-  VK_CHECK(vkEndCommandBuffer(cmdBuffer));
+    lod = i;
+  }
 
-  VkSubmitInfo submitInfo {};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &cmdBuffer;
+  return lod;
+}
 
-  VK_CHECK(vkQueueSubmit(context.graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE));
-  VK_CHECK(vkQueueWaitIdle(context.graphicsQueue_));
+// rotation holds Euler angles in radians, applied Z, Y, then X
+static Matrix4 ComposeModelMatrix(const Vector3& position, const Vector3& rotation, const Vector3& scale) {
+  Matrix4 model = glm::translate(Matrix4(1.0f), position);
+  model = glm::rotate(model, rotation.z, Vector3(0.0f, 0.0f, 1.0f));
+  model = glm::rotate(model, rotation.y, Vector3(0.0f, 1.0f, 0.0f));
+  model = glm::rotate(model, rotation.x, Vector3(1.0f, 0.0f, 0.0f));
+  model = glm::scale(model, scale);
+  return model;
+}
 
-  vmaDestroyBuffer(context.allocator_, stagingBuffer, stagingBufferAllocation);
-  vkFreeCommandBuffers(context.device_, context.commandPools_[context.graphicsQueueFamilyIndex_], 1, &cmdBuffer);
+Matrix4 V8_StaticMesh::GetModelMatrix() const {
+  return ComposeModelMatrix(position, rotation, scale);
+}
+
+Matrix4 V8_StaticMesh::GetModelMatrix(float alpha) const {
+  if (!hasPreviousTransform || alpha >= 1.0f)
+    return GetModelMatrix();
+
+  // Angles take the short way around, so wrapping from 2pi to 0 doesn't spin the mesh backwards
+  Vector3 turn = glm::mod(rotation - previousRotation + glm::pi<float>(), glm::two_pi<float>()) - glm::pi<float>();
+
+  return ComposeModelMatrix(glm::mix(previousPosition, position, alpha), previousRotation + turn * alpha, glm::mix(previousScale, scale, alpha));
+}
+
+void V8_StaticMesh::UploadVertexData(V8_Context& context) {
+  context.stagingRing_.Upload(vertexBuffer, 0, vertices.data(), vertices.size() * sizeof(V8_Vertex));
+}
+
+void V8_StaticMesh::UploadIndexData(V8_Context& context) {
+  context.stagingRing_.Upload(indexBuffer, 0, indices.data(), indices.size() * sizeof(uint32_t));
+}
+
+void V8_StaticMesh::UploadMeshletData(V8_Context& context) {
+  if (meshlets.empty() || meshletBuffer == VK_NULL_HANDLE)
+    return;
+
+  context.stagingRing_.Upload(meshletBuffer, 0, meshlets.data(), meshlets.size() * sizeof(V8_Meshlet));
 }
 
 V8_StaticMesh::~V8_StaticMesh() {
@@ -162,4 +238,11 @@ V8_StaticMesh::~V8_StaticMesh() {
     indexBuffer = VK_NULL_HANDLE;
     indexBufferAllocation = VK_NULL_HANDLE;
   }
+
+  if (meshletBuffer != VK_NULL_HANDLE && meshletBufferAllocation != VK_NULL_HANDLE) {
+    vmaDestroyBuffer(*allocator_, meshletBuffer, meshletBufferAllocation);
+
+    meshletBuffer = VK_NULL_HANDLE;
+    meshletBufferAllocation = VK_NULL_HANDLE;
+  }
 }
@@ -0,0 +1,221 @@
+#define V8_LOG_CATEGORY V8_LogCategory::Scene
+
+#include <Scene/MeshCache.h>
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+static uint64_t AlignUp(uint64_t value) {
+  return (value + V8_MESH_CACHE_ALIGNMENT - 1) / V8_MESH_CACHE_ALIGNMENT * V8_MESH_CACHE_ALIGNMENT;
+}
+
+static bool IndexRangeValid(uint32_t first, uint32_t count, uint32_t indexCount) {
+  return first <= indexCount && count <= indexCount - first;
+}
+
+bool V8_WriteMeshCache(const std::string& path, const V8_StaticMesh& mesh) {
+  V8_MeshCacheHeader header {};
+  header.magic = V8_MESH_CACHE_MAGIC;
+  header.version = V8_MESH_CACHE_VERSION;
+  header.vertexStride = sizeof(V8_Vertex);
+  header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+  header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+  header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+  header.meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+  header.boundsCenter[0] = mesh.boundsCenter.x;
+  header.boundsCenter[1] = mesh.boundsCenter.y;
+  header.boundsCenter[2] = mesh.boundsCenter.z;
+  header.boundsRadius = mesh.boundsRadius;
+
+  const void* payloads[] = { mesh.vertices.data(), mesh.indices.data(), mesh.lods.data(), mesh.meshlets.data() };
+  uint64_t sizes[] = {
+    mesh.vertices.size() * sizeof(V8_Vertex),
+    mesh.indices.size() * sizeof(uint32_t),
+    mesh.lods.size() * sizeof(V8_MeshLOD),
+    mesh.meshlets.size() * sizeof(V8_Meshlet)
+  };
+
+  uint64_t offset = AlignUp(sizeof(V8_MeshCacheHeader));
+  for (uint32_t i = 0; i < static_cast<uint32_t>(V8_MeshCacheSection::Count); i++) {
+    header.sections[i].offset = offset;
+    header.sections[i].size = sizes[i];
+    offset = AlignUp(offset + sizes[i]);
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    V_ERROR("Failed to open file {}", path);
+    return false;
+  }
+
+  static const char padding[V8_MESH_CACHE_ALIGNMENT] = {};
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  uint64_t written = sizeof(header);
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(V8_MeshCacheSection::Count); i++) {
+    file.write(padding, header.sections[i].offset - written);
+    file.write(static_cast<const char*>(payloads[i]), sizes[i]);
+    written = header.sections[i].offset + sizes[i];
+  }
+
+  file.write(padding, offset - written);
+
+  if (!file.good()) {
+    V_ERROR("Failed to write mesh cache {}", path);
+    return false;
+  }
+
+  return true;
+}
+
+V8_MeshCacheFile::~V8_MeshCacheFile() {
+  Close();
+}
+
+bool V8_MeshCacheFile::Open(const std::string& path) {
+  Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    V_ERROR("Failed to open file {}", path);
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(file, &fileSize);
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (view == nullptr) {
+    V_ERROR("Failed to map file {}", path);
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  file_ = file;
+  mapping_ = mapping;
+  data_ = static_cast<const uint8_t*>(view);
+  size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    V_ERROR("Failed to open file {}", path);
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    V_ERROR("Failed to stat file {}", path);
+    close(fd);
+    return false;
+  }
+
+  void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  if (view == MAP_FAILED) {
+    V_ERROR("Failed to map file {}", path);
+    close(fd);
+    return false;
+  }
+
+  // The whole file is about to be copied into the staging ring, start reading ahead now
+  madvise(view, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+
+  fd_ = fd;
+  data_ = static_cast<const uint8_t*>(view);
+  size_ = static_cast<size_t>(st.st_size);
+#endif
+
+  if (size_ < sizeof(V8_MeshCacheHeader)) {
+    V_ERROR("Mesh cache {} is truncated", path);
+    Close();
+    return false;
+  }
+
+  const V8_MeshCacheHeader& header = Header();
+  if (header.magic != V8_MESH_CACHE_MAGIC || header.version != V8_MESH_CACHE_VERSION || header.vertexStride != sizeof(V8_Vertex)) {
+    V_ERROR("Mesh cache {} has an incompatible header (version {}, stride {})", path, header.version, header.vertexStride);
+    Close();
+    return false;
+  }
+
+  uint64_t elementSizes[] = { sizeof(V8_Vertex), sizeof(uint32_t), sizeof(V8_MeshLOD), sizeof(V8_Meshlet) };
+  uint64_t counts[] = { header.vertexCount, header.indexCount, header.lodCount, header.meshletCount };
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(V8_MeshCacheSection::Count); i++) {
+    const V8_MeshCacheSectionInfo& section = header.sections[i];
+
+    // Written so a crafted offset or size can't wrap around
+    if (section.size != counts[i] * elementSizes[i] || section.offset % V8_MESH_CACHE_ALIGNMENT != 0 || section.offset > size_ || section.size > size_ - section.offset) {
+      V_ERROR("Mesh cache {} has a corrupt section table", path);
+      Close();
+      return false;
+    }
+  }
+
+  // Indexed draws don't bound vertex fetches, one stray index reads past the vertex buffer on the GPU
+  const uint32_t* indices = static_cast<const uint32_t*>(Section(V8_MeshCacheSection::Indices));
+  uint32_t maxIndex = 0;
+  for (uint32_t i = 0; i < header.indexCount; i++)
+    maxIndex = std::max(maxIndex, indices[i]);
+
+  if (header.indexCount != 0 && maxIndex >= header.vertexCount) {
+    V_ERROR("Mesh cache {} has index {} past its {} vertices", path, maxIndex, header.vertexCount);
+    Close();
+    return false;
+  }
+
+  // Both are drawn straight from the index buffer, a range past its end would read out of bounds on the GPU
+  const V8_MeshLOD* lods = static_cast<const V8_MeshLOD*>(Section(V8_MeshCacheSection::LODs));
+  for (uint32_t i = 0; i < header.lodCount; i++) {
+    if (!IndexRangeValid(lods[i].indexOffset, lods[i].indexCount, header.indexCount)) {
+      V_ERROR("Mesh cache {} has LOD {} outside the index buffer", path, i);
+      Close();
+      return false;
+    }
+  }
+
+  const V8_Meshlet* meshlets = static_cast<const V8_Meshlet*>(Section(V8_MeshCacheSection::Meshlets));
+  for (uint32_t i = 0; i < header.meshletCount; i++) {
+    if (!IndexRangeValid(meshlets[i].firstIndex, meshlets[i].indexCount, header.indexCount)) {
+      V_ERROR("Mesh cache {} has meshlet {} outside the index buffer", path, i);
+      Close();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void V8_MeshCacheFile::Close() {
+  if (data_ == nullptr)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(data_);
+  CloseHandle(static_cast<HANDLE>(mapping_));
+  CloseHandle(static_cast<HANDLE>(file_));
+  file_ = nullptr;
+  mapping_ = nullptr;
+#else
+  munmap(const_cast<uint8_t*>(data_), size_);
+  close(fd_);
+  fd_ = -1;
+#endif
+
+  data_ = nullptr;
+  size_ = 0;
+}
@@ -0,0 +1,143 @@
+#include <Scene/Meshlet.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+static void ComputeMeshletBounds(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, V8_Meshlet& meshlet) {
+  const uint32_t* tris = &indices[meshlet.firstIndex];
+  uint32_t triangleCount = meshlet.indexCount / 3;
+
+  Vector3 minPos(FLT_MAX);
+  Vector3 maxPos(-FLT_MAX);
+  for (uint32_t i = 0; i < meshlet.indexCount; i++) {
+    minPos = glm::min(minPos, vertices[tris[i]].position);
+    maxPos = glm::max(maxPos, vertices[tris[i]].position);
+  }
+
+  meshlet.center = (minPos + maxPos) * 0.5f;
+  meshlet.radius = 0.0f;
+  for (uint32_t i = 0; i < meshlet.indexCount; i++)
+    meshlet.radius = std::max(meshlet.radius, glm::length(vertices[tris[i]].position - meshlet.center));
+
+  std::vector<Vector3> normals;
+  normals.reserve(triangleCount);
+
+  Vector3 axis(0.0f);
+  for (uint32_t t = 0; t < triangleCount; t++) {
+    const Vector3& p0 = vertices[tris[t * 3 + 0]].position;
+    const Vector3& p1 = vertices[tris[t * 3 + 1]].position;
+    const Vector3& p2 = vertices[tris[t * 3 + 2]].position;
+
+    Vector3 n = glm::cross(p1 - p0, p2 - p0);
+    float area = glm::length(n);
+    if (area <= 0.0f) continue;
+
+    n /= area;
+    normals.push_back(n);
+    axis += n;
+  }
+
+  meshlet.coneAxis = Vector3(0.0f);
+  meshlet.coneApex = meshlet.center;
+  meshlet.coneCutoff = 1.0f;
+
+  float axisLength = glm::length(axis);
+  if (normals.empty() || axisLength <= 0.0f)
+    return;
+
+  axis /= axisLength;
+
+  float minDot = 1.0f;
+  for (const auto& n : normals)
+    minDot = std::min(minDot, glm::dot(axis, n));
+
+  // Cones wider than ~85 degrees almost never cull anything
+  if (minDot <= 0.1f)
+    return;
+
+  // Slide the apex back along the axis until it is behind every triangle plane
+  float maxT = 0.0f;
+  for (uint32_t t = 0, n = 0; t < triangleCount; t++) {
+    const Vector3& p0 = vertices[tris[t * 3 + 0]].position;
+    const Vector3& p1 = vertices[tris[t * 3 + 1]].position;
+    const Vector3& p2 = vertices[tris[t * 3 + 2]].position;
+
+    if (glm::length(glm::cross(p1 - p0, p2 - p0)) <= 0.0f) continue;
+
+    const Vector3& normal = normals[n++];
+    float dc = glm::dot(meshlet.center - p0, normal);
+    float dn = glm::dot(axis, normal);
+
+    maxT = std::max(maxT, dc / dn);
+  }
+
+  meshlet.coneAxis = axis;
+  meshlet.coneApex = meshlet.center - axis * maxT;
+  meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+std::vector<V8_Meshlet> V8_BuildMeshlets(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t indexOffset, uint32_t indexCount, uint32_t maxVertices, uint32_t maxTriangles) {
+  std::vector<V8_Meshlet> meshlets;
+
+  // Meshlet id that last referenced each vertex, for O(1) uniqueness checks
+  std::vector<uint32_t> lastMeshlet(vertices.size(), UINT32_MAX);
+
+  V8_Meshlet current;
+  current.firstIndex = indexOffset;
+
+  for (uint32_t i = indexOffset; i + 2 < indexOffset + indexCount; i += 3) {
+    uint32_t meshletId = static_cast<uint32_t>(meshlets.size());
+
+    uint32_t newVertices = 0;
+    for (int k = 0; k < 3; k++) {
+      if (lastMeshlet[indices[i + k]] != meshletId)
+        newVertices++;
+    }
+
+    if (current.vertexCount + newVertices > maxVertices || current.indexCount / 3 + 1 > maxTriangles) {
+      meshlets.push_back(current);
+      meshletId++;
+
+      current = V8_Meshlet();
+      current.firstIndex = i;
+    }
+
+    for (int k = 0; k < 3; k++) {
+      if (lastMeshlet[indices[i + k]] != meshletId) {
+        lastMeshlet[indices[i + k]] = meshletId;
+        current.vertexCount++;
+      }
+    }
+
+    current.indexCount += 3;
+  }
+
+  if (current.indexCount > 0)
+    meshlets.push_back(current);
+
+  for (auto& meshlet : meshlets)
+    ComputeMeshletBounds(vertices, indices, meshlet);
+
+  return meshlets;
+}
+
+void V8_ExtractFrustumPlanes(const Matrix4& m, glm::vec4 planes[6]) {
+  glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+  glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+  glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+  glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+  planes[0] = row3 + row0; // left
+  planes[1] = row3 - row0; // right
+  planes[2] = row3 + row1; // bottom
+  planes[3] = row3 - row1; // top
+  planes[4] = row2;        // near, Vulkan depth range is [0, 1]
+  planes[5] = row3 - row2; // far
+
+  for (int i = 0; i < 6; i++) {
+    float length = glm::length(Vector3(planes[i].x, planes[i].y, planes[i].z));
+    if (length > 0.0f)
+      planes[i] = planes[i] / length;
+  }
+}
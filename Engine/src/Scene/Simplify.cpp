@@ -0,0 +1,388 @@
+#include <Scene/Simplify.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+struct Quadric {
+  double a2 = 0, b2 = 0, c2 = 0, d2 = 0;
+  double ab = 0, ac = 0, ad = 0;
+  double bc = 0, bd = 0, cd = 0;
+  double w = 0;
+
+  void AddPlane(double a, double b, double c, double d, double weight) {
+    a2 += a * a * weight; b2 += b * b * weight; c2 += c * c * weight; d2 += d * d * weight;
+    ab += a * b * weight; ac += a * c * weight; ad += a * d * weight;
+    bc += b * c * weight; bd += b * d * weight; cd += c * d * weight;
+    w += weight;
+  }
+
+  void Add(const Quadric& q) {
+    a2 += q.a2; b2 += q.b2; c2 += q.c2; d2 += q.d2;
+    ab += q.ab; ac += q.ac; ad += q.ad;
+    bc += q.bc; bd += q.bd; cd += q.cd;
+    w += q.w;
+  }
+
+  // Area weighted mean of squared distances from v to the accumulated planes
+  double Error(const Vector3& v) const {
+    if (w <= 0.0) return 0.0;
+
+    double x = v.x, y = v.y, z = v.z;
+    double r = a2 * x * x + b2 * y * y + c2 * z * z + d2
+             + 2.0 * (ab * x * y + ac * x * z + ad * x + bc * y * z + bd * y + cd * z);
+
+    return std::fabs(r) / w;
+  }
+};
+
+struct Collapse {
+  uint32_t from;
+  uint32_t to;
+  double error;
+
+  // The other side of a seam collapses along with it, UINT32_MAX when there is none
+  uint32_t siblingFrom = UINT32_MAX;
+  uint32_t siblingTo = UINT32_MAX;
+};
+
+struct PositionKey {
+  uint32_t x, y, z;
+
+  bool operator==(const PositionKey& other) const {
+    return x == other.x && y == other.y && z == other.z;
+  }
+};
+
+struct PositionKeyHash {
+  size_t operator()(const PositionKey& k) const {
+    return (size_t(k.x) * 73856093u) ^ (size_t(k.y) * 19349663u) ^ (size_t(k.z) * 83492791u);
+  }
+};
+
+static PositionKey MakePositionKey(const Vector3& p) {
+  PositionKey key;
+  std::memcpy(&key.x, &p.x, sizeof(float));
+  std::memcpy(&key.y, &p.y, sizeof(float));
+  std::memcpy(&key.z, &p.z, sizeof(float));
+  return key;
+}
+
+struct VertexKeyHash {
+  size_t operator()(const V8_Vertex& v) const {
+    uint32_t words[sizeof(V8_Vertex) / sizeof(uint32_t)];
+    std::memcpy(words, &v, sizeof(words));
+
+    size_t hash = 0;
+    for (uint32_t word : words)
+      hash = hash * 31 + word;
+    return hash;
+  }
+};
+
+struct VertexKeyEqual {
+  bool operator()(const V8_Vertex& a, const V8_Vertex& b) const {
+    return std::memcmp(&a, &b, sizeof(V8_Vertex)) == 0;
+  }
+};
+
+enum class VertexKind : uint8_t {
+  Free,   // the only vertex at its position, collapses along any edge
+  Seam,   // one of two vertices at its position, collapses only along the seam together with its sibling
+  Locked  // on an open or non-manifold edge, or where more than two vertices meet
+};
+
+struct VertexClasses {
+  std::vector<uint32_t> canonical; // first vertex with identical attributes
+  std::vector<uint32_t> positionId;
+  std::vector<uint32_t> sibling;
+  std::vector<VertexKind> kind;
+};
+
+static uint64_t EdgeKey(uint64_t a, uint64_t b) {
+  return (a << 32) | b;
+}
+
+// Welds vertices with identical attributes, then classifies the rest by how many
+// distinct vertices share their position and whether their edges are closed.
+static VertexClasses ClassifyVertices(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices) {
+  VertexClasses classes;
+  classes.canonical.resize(vertices.size());
+  classes.positionId.resize(vertices.size());
+  classes.sibling.assign(vertices.size(), UINT32_MAX);
+  classes.kind.assign(vertices.size(), VertexKind::Free);
+
+  std::unordered_map<V8_Vertex, uint32_t, VertexKeyHash, VertexKeyEqual> firstIdentical;
+  std::unordered_map<PositionKey, uint32_t, PositionKeyHash> firstWithPosition;
+  firstIdentical.reserve(vertices.size());
+  firstWithPosition.reserve(vertices.size());
+
+  for (uint32_t i = 0; i < vertices.size(); i++) {
+    classes.canonical[i] = firstIdentical.emplace(vertices[i], i).first->second;
+    classes.positionId[i] = firstWithPosition.emplace(MakePositionKey(vertices[i].position), i).first->second;
+  }
+
+  // Up to two distinct referenced vertices per position, a third one locks the position
+  std::vector<uint32_t> wedges(vertices.size() * 2, UINT32_MAX);
+  std::vector<uint8_t> lockedPosition(vertices.size(), 0);
+
+  for (uint32_t index : indices) {
+    uint32_t v = classes.canonical[index];
+    uint32_t* slot = &wedges[classes.positionId[v] * 2];
+
+    if (slot[0] == UINT32_MAX || slot[0] == v)
+      slot[0] = v;
+    else if (slot[1] == UINT32_MAX || slot[1] == v)
+      slot[1] = v;
+    else
+      lockedPosition[classes.positionId[v]] = 1;
+  }
+
+  std::unordered_map<uint64_t, uint32_t> edgeCounts;
+  edgeCounts.reserve(indices.size());
+
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    for (int e = 0; e < 3; e++) {
+      uint64_t a = classes.positionId[indices[i + e]];
+      uint64_t b = classes.positionId[indices[i + (e + 1) % 3]];
+      if (a > b) std::swap(a, b);
+      edgeCounts[EdgeKey(a, b)]++;
+    }
+  }
+
+  for (const auto& [edge, count] : edgeCounts) {
+    if (count != 2) {
+      lockedPosition[edge >> 32] = 1;
+      lockedPosition[edge & 0xffffffffu] = 1;
+    }
+  }
+
+  for (uint32_t i = 0; i < vertices.size(); i++) {
+    uint32_t position = classes.positionId[i];
+    const uint32_t* slot = &wedges[position * 2];
+
+    if (lockedPosition[position]) {
+      classes.kind[i] = VertexKind::Locked;
+    } else if (slot[1] != UINT32_MAX) {
+      classes.kind[i] = VertexKind::Seam;
+      classes.sibling[i] = slot[0] == i ? slot[1] : slot[0];
+    }
+  }
+
+  return classes;
+}
+
+static Vector3 TriangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2) {
+  return glm::cross(p1 - p0, p2 - p0);
+}
+
+// Rejects collapses that would flip or fully degenerate a triangle that survives the collapse
+static bool CollapseFlipsTriangles(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                   const std::vector<uint32_t>& adjacencyOffsets, const std::vector<uint32_t>& adjacency,
+                                   uint32_t from, uint32_t to) {
+  const Vector3& target = vertices[to].position;
+
+  for (uint32_t j = adjacencyOffsets[from]; j < adjacencyOffsets[from + 1]; j++) {
+    const uint32_t* tri = &indices[adjacency[j] * 3];
+
+    if (tri[0] == to || tri[1] == to || tri[2] == to)
+      continue;
+
+    Vector3 p[3] = { vertices[tri[0]].position, vertices[tri[1]].position, vertices[tri[2]].position };
+    Vector3 before = TriangleNormal(p[0], p[1], p[2]);
+
+    for (int k = 0; k < 3; k++) {
+      if (tri[k] == from)
+        p[k] = target;
+    }
+
+    Vector3 after = TriangleNormal(p[0], p[1], p[2]);
+
+    if (glm::dot(before, after) <= 1e-3f * glm::dot(before, before))
+      return true;
+  }
+
+  return false;
+}
+
+std::vector<uint32_t> V8_SimplifyMesh(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float targetError, float* resultError) {
+  std::vector<uint32_t> result = indices;
+  double maxError = 0.0;
+
+  if (resultError) *resultError = 0.0f;
+  if (result.size() <= targetIndexCount || vertices.empty())
+    return result;
+
+  VertexClasses classes = ClassifyVertices(vertices, indices);
+  const std::vector<uint32_t>& positionId = classes.positionId;
+
+  for (uint32_t& index : result)
+    index = classes.canonical[index];
+
+  // Quadrics are per position so both sides of a seam measure the same surface
+  std::vector<Quadric> quadrics(vertices.size());
+  for (size_t i = 0; i + 2 < result.size(); i += 3) {
+    const Vector3& p0 = vertices[result[i + 0]].position;
+    const Vector3& p1 = vertices[result[i + 1]].position;
+    const Vector3& p2 = vertices[result[i + 2]].position;
+
+    Vector3 n = TriangleNormal(p0, p1, p2);
+    double area = glm::length(n);
+    if (area <= 0.0) continue;
+
+    double a = n.x / area, b = n.y / area, c = n.z / area;
+    double d = -(a * p0.x + b * p0.y + c * p0.z);
+
+    for (int k = 0; k < 3; k++)
+      quadrics[positionId[result[i + k]]].AddPlane(a, b, c, d, area * 0.5);
+  }
+
+  double targetErrorSq = double(targetError) * double(targetError);
+
+  std::vector<uint32_t> adjacencyOffsets;
+  std::vector<uint32_t> adjacency;
+  std::vector<Collapse> collapses;
+  std::vector<uint32_t> remap(vertices.size());
+  std::vector<uint8_t> touched(vertices.size());
+  std::unordered_map<uint64_t, uint64_t> halfEdges;
+
+  while (result.size() > targetIndexCount) {
+    size_t triangleCount = result.size() / 3;
+
+    // Vertex -> triangle adjacency for the current index list
+    adjacencyOffsets.assign(vertices.size() + 1, 0);
+    for (uint32_t index : result)
+      adjacencyOffsets[index + 1]++;
+    for (size_t i = 0; i < vertices.size(); i++)
+      adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+    adjacency.resize(result.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+      for (int k = 0; k < 3; k++)
+        adjacency[fill[result[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    // Half-edges by position, so a seam edge finds the vertices on its other side
+    halfEdges.clear();
+    for (size_t t = 0; t < triangleCount; t++) {
+      for (int k = 0; k < 3; k++) {
+        uint32_t i0 = result[t * 3 + k];
+        uint32_t i1 = result[t * 3 + (k + 1) % 3];
+        halfEdges[EdgeKey(positionId[i0], positionId[i1])] = EdgeKey(i0, i1);
+      }
+    }
+
+    // Every half-edge whose source vertex may move is a candidate
+    collapses.clear();
+    for (size_t t = 0; t < triangleCount; t++) {
+      for (int k = 0; k < 3; k++) {
+        uint32_t i0 = result[t * 3 + k];
+        uint32_t i1 = result[t * 3 + (k + 1) % 3];
+
+        if (classes.kind[i0] == VertexKind::Locked)
+          continue;
+
+        Quadric q = quadrics[positionId[i0]];
+        q.Add(quadrics[positionId[i1]]);
+        Collapse collapse = { i0, i1, q.Error(vertices[i1].position) };
+
+        // A seam vertex may only slide along the seam, and only if the vertex on the
+        // other side slides onto the same position
+        if (classes.kind[i0] == VertexKind::Seam) {
+          auto opposite = halfEdges.find(EdgeKey(positionId[i1], positionId[i0]));
+          if (opposite == halfEdges.end())
+            continue;
+
+          uint32_t j1 = static_cast<uint32_t>(opposite->second >> 32);
+          uint32_t j0 = static_cast<uint32_t>(opposite->second & 0xffffffffu);
+          if (j0 != classes.sibling[i0])
+            continue;
+
+          collapse.siblingFrom = j0;
+          collapse.siblingTo = j1;
+        }
+
+        collapses.push_back(collapse);
+      }
+    }
+
+    if (collapses.empty())
+      break;
+
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+      return a.error < b.error;
+    });
+
+    for (uint32_t i = 0; i < remap.size(); i++)
+      remap[i] = i;
+    std::fill(touched.begin(), touched.end(), 0);
+
+    // Each collapse removes roughly two triangles; apply a batch of independent collapses per pass
+    size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+    size_t trianglesRemoved = 0;
+    size_t applied = 0;
+
+    for (const Collapse& c : collapses) {
+      if (c.error > targetErrorSq || trianglesRemoved >= trianglesToRemove)
+        break;
+
+      bool seam = c.siblingFrom != UINT32_MAX;
+
+      if (touched[c.from] || touched[c.to] || (seam && (touched[c.siblingFrom] || touched[c.siblingTo])))
+        continue;
+
+      if (CollapseFlipsTriangles(vertices, result, adjacencyOffsets, adjacency, c.from, c.to))
+        continue;
+
+      if (seam && CollapseFlipsTriangles(vertices, result, adjacencyOffsets, adjacency, c.siblingFrom, c.siblingTo))
+        continue;
+
+      // Freeze the one-ring of the collapsed vertices so flip checks in this pass stay valid
+      for (uint32_t from : { c.from, c.siblingFrom }) {
+        if (from == UINT32_MAX)
+          continue;
+
+        uint32_t to = from == c.from ? c.to : c.siblingTo;
+        for (uint32_t j = adjacencyOffsets[from]; j < adjacencyOffsets[from + 1]; j++) {
+          const uint32_t* tri = &result[adjacency[j] * 3];
+          touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+
+          if (tri[0] == to || tri[1] == to || tri[2] == to)
+            trianglesRemoved++;
+        }
+
+        touched[to] = 1;
+        remap[from] = to;
+      }
+
+      quadrics[positionId[c.to]].Add(quadrics[positionId[c.from]]);
+      maxError = std::max(maxError, c.error);
+      applied++;
+    }
+
+    if (applied == 0)
+      break;
+
+    size_t write = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+      uint32_t a = remap[result[t * 3 + 0]];
+      uint32_t b = remap[result[t * 3 + 1]];
+      uint32_t c = remap[result[t * 3 + 2]];
+
+      if (a == b || b == c || a == c)
+        continue;
+
+      result[write++] = a;
+      result[write++] = b;
+      result[write++] = c;
+    }
+
+    result.resize(write);
+  }
+
+  if (resultError) *resultError = static_cast<float>(std::sqrt(maxError));
+
+  return result;
+}
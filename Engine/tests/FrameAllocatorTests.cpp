@@ -0,0 +1,95 @@
+#include <Core/FrameAllocator.h>
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+
+// These share the global frameAllocator, as V8_FrameStlAllocator does, so each starts with Init and a new frame
+
+TEST(FrameAllocator, RegionIsReusedOnceItsFrameComesAround) {
+  frameAllocator.Init(3, 4096);
+
+  void* first[3];
+  for (void*& pointer : first) {
+    frameAllocator.BeginFrame();
+    pointer = frameAllocator.Allocate(64);
+  }
+
+  EXPECT_NE(first[0], first[1]);
+  EXPECT_NE(first[1], first[2]);
+  EXPECT_NE(first[0], first[2]);
+
+  for (void* pointer : first) {
+    frameAllocator.BeginFrame();
+    EXPECT_EQ(frameAllocator.Allocate(64), pointer);
+  }
+}
+
+TEST(FrameAllocator, DataSurvivesWhileItsFrameIsInFlight) {
+  frameAllocator.Init(2, 4096);
+  frameAllocator.BeginFrame();
+
+  char* kept = static_cast<char*>(frameAllocator.Allocate(256));
+  std::memset(kept, 0x5a, 256);
+
+  frameAllocator.BeginFrame();
+  for (int i = 0; i < 64; i++)
+    std::memset(frameAllocator.Allocate(256), 0, 256);
+
+  for (int i = 0; i < 256; i++)
+    ASSERT_EQ(kept[i], 0x5a);
+}
+
+TEST(FrameAllocator, AllocationsAreAlignedAndDisjoint) {
+  frameAllocator.Init(2, 4096);
+  frameAllocator.BeginFrame();
+
+  std::byte* previousEnd = nullptr;
+  for (size_t alignment : { 1, 8, 16, 64, 256, 4 }) {
+    std::byte* pointer = static_cast<std::byte*>(frameAllocator.Allocate(3, alignment));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignment, 0u);
+
+    // Same block, so each allocation starts past the one before it
+    if (previousEnd != nullptr) {
+      EXPECT_GE(pointer, previousEnd);
+    }
+    previousEnd = pointer + 3;
+  }
+}
+
+TEST(FrameAllocator, OversizedAllocationsKeepTheirBlock) {
+  frameAllocator.Init(2, 1024);
+  frameAllocator.BeginFrame();
+
+  void* large = frameAllocator.Allocate(16 * 1024, 64);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0u);
+  std::memset(large, 0, 16 * 1024);
+
+  frameAllocator.BeginFrame();
+  frameAllocator.BeginFrame();
+  EXPECT_EQ(frameAllocator.Allocate(16 * 1024, 64), large);
+}
+
+TEST(FrameAllocator, ThreadsAllocateFromTheirOwnArenas) {
+  frameAllocator.Init(2, 4096);
+  frameAllocator.BeginFrame();
+
+  void* mine = frameAllocator.Allocate(64);
+  void* other = nullptr;
+  std::thread([&] { other = frameAllocator.Allocate(64); }).join();
+
+  EXPECT_NE(mine, other);
+  EXPECT_NE(other, nullptr);
+}
+
+TEST(FrameAllocator, FrameVectorGrowsWithinTheFrame) {
+  frameAllocator.Init(2, 4096);
+  frameAllocator.BeginFrame();
+
+  V8_FrameVector<int> values;
+  for (int i = 0; i < 10000; i++)
+    values.push_back(i);
+
+  for (int i = 0; i < 10000; i++)
+    ASSERT_EQ(values[i], i);
+}
@@ -0,0 +1,94 @@
+#include <Core/FrameStats.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+  V8_FrameSample Sample(double total, double wait = 0.0) {
+    V8_FrameSample sample;
+    sample[V8_FramePhase::Total] = total;
+    sample[V8_FramePhase::Wait] = wait;
+    return sample;
+  }
+}
+
+TEST(FrameStats, EmptySummaryIsZero) {
+  V8_FrameStats stats;
+  stats.Init(8, 0.0, "");
+
+  V8_FrameSummary summary = stats.Summarize(V8_FramePhase::Total);
+  EXPECT_EQ(stats.Count(), 0u);
+  EXPECT_EQ(summary.mean, 0.0);
+  EXPECT_EQ(summary.p50, 0.0);
+  EXPECT_EQ(summary.max, 0.0);
+}
+
+TEST(FrameStats, NearestRankPercentiles) {
+  std::vector<double> values(100);
+  std::iota(values.begin(), values.end(), 1.0);
+  std::shuffle(values.begin(), values.end(), std::mt19937(7));
+
+  V8_FrameStats stats;
+  stats.Init(100, 0.0, "");
+  for (double value : values)
+    stats.Add(Sample(value));
+
+  V8_FrameSummary summary = stats.Summarize(V8_FramePhase::Total);
+  EXPECT_DOUBLE_EQ(summary.mean, 50.5);
+  EXPECT_EQ(summary.p50, 50.0);
+  EXPECT_EQ(summary.p95, 95.0);
+  EXPECT_EQ(summary.p99, 99.0);
+  EXPECT_EQ(summary.max, 100.0);
+}
+
+TEST(FrameStats, PercentilesOfFewFramesAreActualSamples) {
+  V8_FrameStats stats;
+  stats.Init(8, 0.0, "");
+  for (double value : { 30.0, 10.0, 20.0 })
+    stats.Add(Sample(value));
+
+  V8_FrameSummary summary = stats.Summarize(V8_FramePhase::Total);
+  EXPECT_DOUBLE_EQ(summary.mean, 20.0);
+  EXPECT_EQ(summary.p50, 20.0);
+  EXPECT_EQ(summary.p95, 30.0);
+  EXPECT_EQ(summary.p99, 30.0);
+  EXPECT_EQ(summary.max, 30.0);
+}
+
+TEST(FrameStats, RingKeepsTheLastFrames) {
+  V8_FrameStats stats;
+  stats.Init(4, 0.0, "");
+  for (int i = 1; i <= 10; i++)
+    stats.Add(Sample(i));
+
+  V8_FrameSummary summary = stats.Summarize(V8_FramePhase::Total);
+  EXPECT_EQ(stats.Count(), 4u);
+  EXPECT_DOUBLE_EQ(summary.mean, 8.5);
+  EXPECT_EQ(summary.p50, 8.0);
+  EXPECT_EQ(summary.max, 10.0);
+}
+
+TEST(FrameStats, PhasesAreSummarizedSeparately) {
+  V8_FrameStats stats;
+  stats.Init(4, 0.0, "");
+  stats.Add(Sample(16.0, 4.0));
+  stats.Add(Sample(20.0, 1.0));
+
+  EXPECT_EQ(stats.Summarize(V8_FramePhase::Total).max, 20.0);
+  EXPECT_EQ(stats.Summarize(V8_FramePhase::Wait).max, 4.0);
+  EXPECT_EQ(stats.Summarize(V8_FramePhase::Record).max, 0.0);
+}
+
+TEST(FrameStats, ClearStartsOver) {
+  V8_FrameStats stats;
+  stats.Init(4, 0.0, "");
+  stats.Add(Sample(50.0));
+  stats.Clear();
+  stats.Add(Sample(5.0));
+
+  EXPECT_EQ(stats.Count(), 1u);
+  EXPECT_EQ(stats.Summarize(V8_FramePhase::Total).max, 5.0);
+}
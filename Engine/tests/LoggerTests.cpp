@@ -0,0 +1,259 @@
+#include <Core/LogSink.h>
+#include <Core/Logger.h>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+namespace {
+  // Records every message and can hold the thread that calls Append or Flush until released.
+  // A thread held in Flush keeps the output lock without a queue slot, one held in Append
+  // also keeps the slot of the message it is writing.
+  class GateSink : public V8_LogSink {
+    private:
+      std::mutex mutex_;
+      std::condition_variable condition_;
+      bool holdAppend_ = false;
+      bool holdFlush_ = false;
+      bool held_ = false;
+      std::vector<std::string> messages_;
+
+      void Hold(const bool& flag, std::unique_lock<std::mutex>& lock) {
+        if (!flag)
+          return;
+
+        held_ = true;
+        condition_.notify_all();
+        condition_.wait(lock, [&] { return !flag; });
+      }
+
+    public:
+      void Append(const V8_LogRecord& record) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Hold(holdAppend_, lock);
+        messages_.emplace_back(record.message);
+      }
+
+      void EndBatch() override {}
+
+      void Flush() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Hold(holdFlush_, lock);
+      }
+
+      void HoldAppend() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        holdAppend_ = true;
+      }
+
+      void HoldFlush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        holdFlush_ = true;
+      }
+
+      void WaitUntilHeld() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&] { return held_; });
+      }
+
+      void Release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        holdAppend_ = holdFlush_ = false;
+        condition_.notify_all();
+      }
+
+      std::vector<std::string> Messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+      }
+  };
+
+  // Distinct messages, repeats would be collapsed
+  void LogNumbered(V8_Logger& log, uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++)
+      log.Log(V8_Logger::LogLevel::Info, "LoggerTests", "message {}", i);
+  }
+
+  std::string Numbered(uint32_t i) {
+    return "message " + std::to_string(i);
+  }
+
+  // What the logger thread produces for a deferred call with these arguments
+  template <typename... Args>
+  std::string FormatCaptured(std::string_view format, bool& truncated, const Args&... args) {
+    char payload[V8_LOG_MESSAGE_CAPACITY];
+    V8_LogArgWriter writer { payload, sizeof(payload) };
+    (writer.Write(args), ...);
+    truncated = writer.truncated;
+
+    std::string out;
+    if (!V8_Logger::FormatDeferred(out, format, payload, writer.size))
+      truncated = true;
+    return out;
+  }
+
+  template <typename... Args>
+  std::string FormatCaptured(std::string_view format, const Args&... args) {
+    bool truncated;
+    std::string out = FormatCaptured(format, truncated, args...);
+    EXPECT_FALSE(truncated);
+    return out;
+  }
+
+  class LoggerOverflow : public testing::Test {
+    protected:
+      static constexpr uint32_t overflow = 10;
+
+      std::ostringstream console_;
+      V8_Logger log_ { &console_ };
+      std::shared_ptr<GateSink> sink_ = std::make_shared<GateSink>();
+      std::thread flusher_;
+
+      void SetUp() override {
+        log_.AddSink(sink_);
+      }
+
+      // Stops the consumer from draining while leaving every slot free
+      void StallConsumer() {
+        sink_->HoldFlush();
+        flusher_ = std::thread([this] { log_.Flush(); });
+        sink_->WaitUntilHeld();
+      }
+
+      std::vector<std::string> Resume() {
+        sink_->Release();
+        if (flusher_.joinable())
+          flusher_.join();
+
+        log_.Flush();
+        return sink_->Messages();
+      }
+  };
+}
+
+TEST_F(LoggerOverflow, DropKeepsTheOldestMessages) {
+  log_.SetBackpressure(V8_Logger::Backpressure::Drop);
+  StallConsumer();
+
+  LogNumbered(log_, 0, V8_LOG_QUEUE_CAPACITY + overflow);
+  EXPECT_EQ(log_.DroppedCount(), overflow);
+
+  std::vector<std::string> messages = Resume();
+  ASSERT_EQ(messages.size(), V8_LOG_QUEUE_CAPACITY + 1u);
+  for (uint32_t i = 0; i < V8_LOG_QUEUE_CAPACITY; i++)
+    ASSERT_EQ(messages[i], Numbered(i));
+  EXPECT_EQ(messages.back(), std::to_string(overflow) + " log messages dropped, queue full");
+}
+
+TEST_F(LoggerOverflow, OverwriteKeepsTheNewestMessages) {
+  log_.SetBackpressure(V8_Logger::Backpressure::Overwrite);
+  StallConsumer();
+
+  LogNumbered(log_, 0, V8_LOG_QUEUE_CAPACITY + overflow);
+  EXPECT_EQ(log_.DroppedCount(), overflow);
+
+  std::vector<std::string> messages = Resume();
+  ASSERT_EQ(messages.size(), V8_LOG_QUEUE_CAPACITY + 1u);
+  for (uint32_t i = 0; i < V8_LOG_QUEUE_CAPACITY; i++)
+    ASSERT_EQ(messages[i], Numbered(i + overflow));
+  EXPECT_EQ(messages.back(), std::to_string(overflow) + " log messages dropped, queue full");
+}
+
+TEST_F(LoggerOverflow, OverwriteWaitsForTheMessageBeingWritten) {
+  log_.SetBackpressure(V8_Logger::Backpressure::Overwrite);
+
+  // The consumer holds the first message's slot, the rest of the queue fills behind it
+  sink_->HoldAppend();
+  log_.Log(V8_Logger::LogLevel::Info, "LoggerTests", "first");
+  sink_->WaitUntilHeld();
+
+  std::thread producer([this] { LogNumbered(log_, 0, V8_LOG_QUEUE_CAPACITY); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  sink_->Release();
+  producer.join();
+
+  std::vector<std::string> messages = Resume();
+
+  EXPECT_EQ(log_.DroppedCount(), 0u);
+  ASSERT_EQ(messages.size(), V8_LOG_QUEUE_CAPACITY + 1u);
+  EXPECT_EQ(messages.front(), "first");
+  EXPECT_EQ(messages.back(), Numbered(V8_LOG_QUEUE_CAPACITY - 1));
+}
+
+TEST_F(LoggerOverflow, BlockWaitsForTheConsumer) {
+  log_.SetBackpressure(V8_Logger::Backpressure::Block);
+  StallConsumer();
+
+  std::atomic<bool> done = false;
+  std::thread producer([&] {
+    LogNumbered(log_, 0, V8_LOG_QUEUE_CAPACITY + overflow);
+    done = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(done);
+
+  sink_->Release();
+  producer.join();
+
+  std::vector<std::string> messages = Resume();
+  EXPECT_EQ(log_.DroppedCount(), 0u);
+  ASSERT_EQ(messages.size(), V8_LOG_QUEUE_CAPACITY + overflow);
+  for (uint32_t i = 0; i < messages.size(); i++)
+    ASSERT_EQ(messages[i], Numbered(i));
+}
+
+TEST(LoggerDeferred, MatchesEagerFormatting) {
+  int value = 42;
+  const int* pointer = &value;
+  std::string text = "text";
+  std::string_view view = "view";
+  char buffer[16] = "buffer";
+
+  EXPECT_EQ(FormatCaptured("{:.3f} {}", 1.25f, 0.1f), fmt::format("{:.3f} {}", 1.25f, 0.1f));
+  EXPECT_EQ(FormatCaptured("{} {:.2e}", 3.0625, 1e-300), fmt::format("{} {:.2e}", 3.0625, 1e-300));
+  EXPECT_EQ(FormatCaptured("{} {} {:x}", -7, uint64_t(1) << 63, 255u), fmt::format("{} {} {:x}", -7, uint64_t(1) << 63, 255u));
+  EXPECT_EQ(FormatCaptured("{} {} {}", true, false, 'c'), fmt::format("{} {} {}", true, false, 'c'));
+  EXPECT_EQ(FormatCaptured("{} {} {}", "literal", text, view), "literal text view");
+  EXPECT_EQ(FormatCaptured("[{}]", buffer), "[buffer]");
+  EXPECT_EQ(FormatCaptured("{}", static_cast<const void*>(pointer)), fmt::format("{}", static_cast<const void*>(pointer)));
+}
+
+TEST(LoggerDeferred, NullStringPrintsPlaceholder) {
+  const char* missing = nullptr;
+  EXPECT_EQ(FormatCaptured("name {}", missing), "name (null)");
+}
+
+TEST(LoggerDeferred, UnterminatedBufferStopsAtItsExtent) {
+  char buffer[4];
+  std::memcpy(buffer, "abcd", 4);
+  EXPECT_EQ(FormatCaptured("{}|", buffer), "abcd|");
+}
+
+TEST(LoggerDeferred, OversizedStringIsTruncated) {
+  std::string text(V8_LOG_MESSAGE_CAPACITY * 2, 'x');
+
+  bool truncated;
+  std::string out = FormatCaptured("{}", truncated, text);
+  EXPECT_TRUE(truncated);
+  EXPECT_LT(out.size(), text.size());
+  EXPECT_EQ(out, std::string(out.size(), 'x'));
+}
+
+TEST(LoggerDeferred, MissingArgumentsFallBackToTheFormat) {
+  std::string text(V8_LOG_MESSAGE_CAPACITY, 'x');
+
+  bool truncated;
+  std::string out = FormatCaptured("{} {}", truncated, text, 1);
+  EXPECT_TRUE(truncated);
+  EXPECT_EQ(out, "{} {}");
+}
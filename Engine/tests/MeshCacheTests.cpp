@@ -0,0 +1,100 @@
+#include <Scene/MeshCache.h>
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <cstring>
+#include <string>
+
+namespace {
+  // Two quads, a coarser LOD after the full one and a meshlet over the first
+  V8_StaticMesh BuildMesh() {
+    V8_StaticMesh mesh;
+    for (uint32_t i = 0; i < 6; i++)
+      mesh.vertices.push_back({ Vector3(float(i), float(i % 2), 0.0f), Vector3(0.0f, 0.0f, 1.0f), Vector3(1.0f), Vector2(0.5f) });
+
+    mesh.indices = { 0, 1, 3, 0, 3, 2, 2, 3, 5, 2, 5, 4, 0, 1, 5 };
+    mesh.lods = { { 0, 12, 0.0f }, { 12, 3, 0.25f } };
+
+    V8_Meshlet meshlet;
+    meshlet.firstIndex = 0;
+    meshlet.indexCount = 12;
+    meshlet.vertexCount = 6;
+    mesh.meshlets.push_back(meshlet);
+
+    mesh.boundsCenter = Vector3(2.5f, 0.5f, 0.0f);
+    mesh.boundsRadius = 2.6f;
+    return mesh;
+  }
+
+  std::string CachePath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  template <typename T>
+  bool SectionEquals(const V8_MeshCacheFile& cache, V8_MeshCacheSection section, const std::vector<T>& expected) {
+    return cache.SectionSize(section) == expected.size() * sizeof(T) && std::memcmp(cache.Section(section), expected.data(), cache.SectionSize(section)) == 0;
+  }
+}
+
+TEST(MeshCache, RoundTripKeepsTheMesh) {
+  V8_StaticMesh mesh = BuildMesh();
+  std::string path = CachePath("v8_mesh_cache_round_trip.v8mc");
+  ASSERT_TRUE(V8_WriteMeshCache(path, mesh));
+
+  V8_MeshCacheFile cache;
+  ASSERT_TRUE(cache.Open(path));
+
+  const V8_MeshCacheHeader& header = cache.Header();
+  EXPECT_EQ(header.vertexCount, mesh.vertices.size());
+  EXPECT_EQ(header.indexCount, mesh.indices.size());
+  EXPECT_EQ(header.lodCount, mesh.lods.size());
+  EXPECT_EQ(header.meshletCount, mesh.meshlets.size());
+  EXPECT_EQ(header.boundsCenter[0], mesh.boundsCenter.x);
+  EXPECT_EQ(header.boundsRadius, mesh.boundsRadius);
+
+  EXPECT_TRUE(SectionEquals(cache, V8_MeshCacheSection::Vertices, mesh.vertices));
+  EXPECT_TRUE(SectionEquals(cache, V8_MeshCacheSection::Indices, mesh.indices));
+  EXPECT_TRUE(SectionEquals(cache, V8_MeshCacheSection::LODs, mesh.lods));
+  EXPECT_TRUE(SectionEquals(cache, V8_MeshCacheSection::Meshlets, mesh.meshlets));
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(V8_MeshCacheSection::Count); i++)
+    EXPECT_EQ(header.sections[i].offset % V8_MESH_CACHE_ALIGNMENT, 0u);
+
+  cache.Close();
+  std::filesystem::remove(path);
+}
+
+TEST(MeshCache, RejectsIndexPastTheVertices) {
+  V8_StaticMesh mesh = BuildMesh();
+  mesh.indices.back() = static_cast<uint32_t>(mesh.vertices.size());
+
+  std::string path = CachePath("v8_mesh_cache_bad_index.v8mc");
+  ASSERT_TRUE(V8_WriteMeshCache(path, mesh));
+
+  V8_MeshCacheFile cache;
+  EXPECT_FALSE(cache.Open(path));
+  EXPECT_FALSE(cache.IsOpen());
+  std::filesystem::remove(path);
+}
+
+TEST(MeshCache, RejectsRangesPastTheIndices) {
+  V8_StaticMesh mesh = BuildMesh();
+  mesh.lods[1].indexCount = 4;
+
+  std::string path = CachePath("v8_mesh_cache_bad_lod.v8mc");
+  ASSERT_TRUE(V8_WriteMeshCache(path, mesh));
+
+  V8_MeshCacheFile cache;
+  EXPECT_FALSE(cache.Open(path));
+  std::filesystem::remove(path);
+}
+
+TEST(MeshCache, RejectsTruncatedFile) {
+  std::string path = CachePath("v8_mesh_cache_truncated.v8mc");
+  ASSERT_TRUE(V8_WriteMeshCache(path, BuildMesh()));
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - V8_MESH_CACHE_ALIGNMENT - 1);
+
+  V8_MeshCacheFile cache;
+  EXPECT_FALSE(cache.Open(path));
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,132 @@
+#include <Scene/Meshlet.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <set>
+
+namespace {
+  // n x n quads over the unit square at z = 0, facing +z
+  void BuildGrid(uint32_t n, std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+    for (uint32_t y = 0; y <= n; y++) {
+      for (uint32_t x = 0; x <= n; x++)
+        vertices.push_back({ Vector3(float(x) / n, float(y) / n, 0.0f), Vector3(0.0f, 0.0f, 1.0f) });
+    }
+
+    for (uint32_t y = 0; y < n; y++) {
+      for (uint32_t x = 0; x < n; x++) {
+        uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+        indices.insert(indices.end(), { a, b, d, a, d, c });
+      }
+    }
+  }
+
+  // The same test shaders/cull.comp runs
+  bool ConeCulls(const V8_Meshlet& meshlet, const Vector3& camera) {
+    return meshlet.coneCutoff < 1.0f && glm::dot(glm::normalize(meshlet.coneApex - camera), meshlet.coneAxis) >= meshlet.coneCutoff;
+  }
+
+  float PlaneDistance(const glm::vec4& plane, const Vector3& point) {
+    return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+  }
+}
+
+TEST(Meshlet, SplitsTrianglesInOrderWithinLimits) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(32, vertices, indices);
+
+  std::vector<V8_Meshlet> meshlets = V8_BuildMeshlets(vertices, indices, 0, static_cast<uint32_t>(indices.size()));
+  ASSERT_FALSE(meshlets.empty());
+
+  uint32_t next = 0;
+  for (const V8_Meshlet& meshlet : meshlets) {
+    EXPECT_EQ(meshlet.firstIndex, next);
+    EXPECT_EQ(meshlet.indexCount % 3, 0u);
+    EXPECT_LE(meshlet.indexCount / 3, static_cast<uint32_t>(V8_MESHLET_MAX_TRIANGLES));
+
+    std::set<uint32_t> unique(indices.begin() + meshlet.firstIndex, indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+    EXPECT_EQ(meshlet.vertexCount, unique.size());
+    EXPECT_LE(meshlet.vertexCount, static_cast<uint32_t>(V8_MESHLET_MAX_VERTICES));
+
+    next += meshlet.indexCount;
+  }
+
+  EXPECT_EQ(next, indices.size());
+}
+
+TEST(Meshlet, HonoursIndexRange) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(8, vertices, indices);
+
+  std::vector<V8_Meshlet> meshlets = V8_BuildMeshlets(vertices, indices, 96, 192, 16, 8);
+  ASSERT_FALSE(meshlets.empty());
+  EXPECT_EQ(meshlets.front().firstIndex, 96u);
+  EXPECT_EQ(meshlets.back().firstIndex + meshlets.back().indexCount, 288u);
+
+  for (const V8_Meshlet& meshlet : meshlets) {
+    EXPECT_LE(meshlet.vertexCount, 16u);
+    EXPECT_LE(meshlet.indexCount / 3, 8u);
+  }
+}
+
+TEST(Meshlet, BoundsContainEveryVertex) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(32, vertices, indices);
+
+  for (const V8_Meshlet& meshlet : V8_BuildMeshlets(vertices, indices, 0, static_cast<uint32_t>(indices.size()))) {
+    for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; i++)
+      EXPECT_LE(glm::length(vertices[indices[i]].position - meshlet.center), meshlet.radius + 1e-5f);
+  }
+}
+
+TEST(Meshlet, ConeCullsOnlyFromBehind) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(4, vertices, indices);
+
+  std::vector<V8_Meshlet> meshlets = V8_BuildMeshlets(vertices, indices, 0, static_cast<uint32_t>(indices.size()));
+  ASSERT_EQ(meshlets.size(), 1u);
+
+  const V8_Meshlet& meshlet = meshlets[0];
+  EXPECT_NEAR(meshlet.coneAxis.z, 1.0f, 1e-5f);
+  EXPECT_LT(meshlet.coneCutoff, 1.0f);
+
+  EXPECT_TRUE(ConeCulls(meshlet, Vector3(0.5f, 0.5f, -5.0f)));
+  EXPECT_FALSE(ConeCulls(meshlet, Vector3(0.5f, 0.5f, 5.0f)));
+  EXPECT_FALSE(ConeCulls(meshlet, Vector3(20.0f, 0.5f, 0.1f)));
+}
+
+TEST(Meshlet, ClosedClusterHasNoCone) {
+  // Octahedron, its normals point every way
+  std::vector<V8_Vertex> vertices = {
+    { Vector3(1, 0, 0) }, { Vector3(-1, 0, 0) }, { Vector3(0, 1, 0) },
+    { Vector3(0, -1, 0) }, { Vector3(0, 0, 1) }, { Vector3(0, 0, -1) }
+  };
+  std::vector<uint32_t> indices = { 0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4, 2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5 };
+
+  std::vector<V8_Meshlet> meshlets = V8_BuildMeshlets(vertices, indices, 0, static_cast<uint32_t>(indices.size()));
+  ASSERT_EQ(meshlets.size(), 1u);
+  EXPECT_EQ(meshlets[0].coneCutoff, 1.0f);
+  EXPECT_NEAR(meshlets[0].radius, 1.0f, 1e-5f);
+}
+
+TEST(Meshlet, FrustumPlanesFollowTheModelMatrix) {
+  // Identity projection, so the frustum is -1..1 in x and y and 0..1 in depth
+  Matrix4 modelViewProjection(1.0f);
+  modelViewProjection[3][0] = 3.0f;
+
+  glm::vec4 planes[6];
+  V8_ExtractFrustumPlanes(modelViewProjection, planes);
+
+  auto inside = [&](const Vector3& point) {
+    return std::all_of(planes, planes + 6, [&](const glm::vec4& plane) { return PlaneDistance(plane, point) >= 0.0f; });
+  };
+
+  EXPECT_TRUE(inside(Vector3(-3.0f, 0.0f, 0.5f)));
+  EXPECT_FALSE(inside(Vector3(0.0f, 0.0f, 0.5f)));
+  EXPECT_FALSE(inside(Vector3(-3.0f, 0.0f, -0.1f)));
+  EXPECT_FALSE(inside(Vector3(-3.0f, 0.0f, 1.1f)));
+  EXPECT_NEAR(PlaneDistance(planes[1], Vector3(-3.0f, 0.0f, 0.5f)), 1.0f, 1e-5f);
+}
@@ -0,0 +1,134 @@
+#include <Core/PoolAllocator.h>
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <set>
+
+// Each test uses its own size class so the pools start out the same whichever runs first
+
+TEST(PoolAllocator, FreedNodeIsHandedOutAgain) {
+  using Pool = V8_Pool<40, 8>;
+  using SharedPool = V8_Pool<40, 8, false>;
+
+  void* node = Pool::Allocate();
+  Pool::Free(node);
+  EXPECT_EQ(Pool::Allocate(), node);
+  Pool::Free(node);
+
+  void* shared = SharedPool::Allocate();
+  SharedPool::Free(shared);
+  EXPECT_EQ(SharedPool::Allocate(), shared);
+  SharedPool::Free(shared);
+}
+
+TEST(PoolAllocator, LiveNodesAreDistinctAndAligned) {
+  using Pool = V8_Pool<48, 64>;
+
+  std::vector<void*> nodes;
+  for (int i = 0; i < 5000; i++) {
+    void* node = Pool::Allocate();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(node) % 64, 0u);
+    std::memset(node, 0xff, 48);
+    nodes.push_back(node);
+  }
+
+  EXPECT_EQ(std::set<void*>(nodes.begin(), nodes.end()).size(), nodes.size());
+
+  for (void* node : nodes)
+    Pool::Free(node);
+}
+
+TEST(PoolAllocator, NodesFreedOnAnotherThreadCanBeReused) {
+  using Pool = V8_Pool<56, 8>;
+
+  std::vector<void*> nodes(10000);
+  std::thread([&] {
+    for (void*& node : nodes)
+      node = Pool::Allocate();
+  }).join();
+
+  std::thread([&] {
+    for (void* node : nodes)
+      Pool::Free(node);
+  }).join();
+
+  // Both threads handed their caches back when they exited, the freed nodes are on top of the shared list
+  std::set<void*> previous(nodes.begin(), nodes.end());
+  size_t reused = 0;
+  for (void*& node : nodes) {
+    node = Pool::Allocate();
+    reused += previous.count(node);
+  }
+
+  EXPECT_EQ(std::set<void*>(nodes.begin(), nodes.end()).size(), nodes.size());
+  EXPECT_EQ(reused, nodes.size());
+
+  for (void* node : nodes)
+    Pool::Free(node);
+}
+
+TEST(PoolAllocator, ExitingThreadReturnsItsCache) {
+  using Pool = V8_Pool<72, 8>;
+
+  void* node = nullptr;
+  std::thread([&] {
+    node = Pool::Allocate();
+    Pool::Free(node);
+  }).join();
+
+  // The released cache is at the front of the shared list, most recently freed node first
+  void* reused = Pool::Allocate();
+  EXPECT_EQ(reused, node);
+  Pool::Free(reused);
+}
+
+TEST(PoolAllocator, MakePooledConstructsAndDestroys) {
+  struct Counted {
+    int& live;
+    std::string name;
+
+    Counted(int& live, std::string name) : live(live), name(std::move(name)) {
+      live++;
+    }
+
+    ~Counted() {
+      live--;
+    }
+  };
+
+  int live = 0;
+  {
+    std::shared_ptr<Counted> first = V8_MakePooled<Counted>(live, "first");
+    std::shared_ptr<Counted> second = first;
+    EXPECT_EQ(live, 1);
+    EXPECT_EQ(second->name, "first");
+  }
+
+  EXPECT_EQ(live, 0);
+}
+
+TEST(PoolAllocator, PooledMapKeepsItsEntries) {
+  V8_PooledMap<int, std::string> map;
+  for (int i = 0; i < 2000; i++)
+    map.emplace(i, std::to_string(i));
+
+  for (int i = 0; i < 2000; i += 2)
+    map.erase(i);
+
+  for (int i = 2000; i < 3000; i++)
+    map.emplace(i, std::to_string(i));
+
+  EXPECT_EQ(map.size(), 2000u);
+  for (int i = 0; i < 3000; i++) {
+    auto it = map.find(i);
+    if (i < 2000 && i % 2 == 0) {
+      EXPECT_EQ(it, map.end());
+    } else {
+      ASSERT_NE(it, map.end());
+      EXPECT_EQ(it->second, std::to_string(i));
+    }
+  }
+}
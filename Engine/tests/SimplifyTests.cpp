@@ -0,0 +1,137 @@
+#include <Scene/Simplify.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+
+namespace {
+  // n x n quads over the unit square at z = 0, sharing vertices
+  void BuildGrid(uint32_t n, std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+    for (uint32_t y = 0; y <= n; y++) {
+      for (uint32_t x = 0; x <= n; x++)
+        vertices.push_back({ Vector3(float(x) / n, float(y) / n, 0.0f), Vector3(0.0f, 0.0f, 1.0f) });
+    }
+
+    for (uint32_t y = 0; y < n; y++) {
+      for (uint32_t x = 0; x < n; x++) {
+        uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+        indices.insert(indices.end(), { a, b, d, a, d, c });
+      }
+    }
+  }
+
+  // Flat-shaded cube: every face is an n x n grid with its own vertices and normal
+  void BuildCube(uint32_t n, std::vector<V8_Vertex>& vertices, std::vector<uint32_t>& indices) {
+    for (int axis = 0; axis < 3; axis++) {
+      for (float side : { -1.0f, 1.0f }) {
+        Vector3 normal(0.0f);
+        normal[axis] = side;
+        Vector3 u(0.0f), v(0.0f);
+        u[(axis + 1) % 3] = 1.0f;
+        v[(axis + 2) % 3] = side;
+
+        uint32_t base = static_cast<uint32_t>(vertices.size());
+        for (uint32_t y = 0; y <= n; y++) {
+          for (uint32_t x = 0; x <= n; x++) {
+            Vector3 p = normal + u * (2.0f * x / n - 1.0f) + v * (2.0f * y / n - 1.0f);
+            vertices.push_back({ p, normal });
+          }
+        }
+
+        for (uint32_t y = 0; y < n; y++) {
+          for (uint32_t x = 0; x < n; x++) {
+            uint32_t a = base + y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+            indices.insert(indices.end(), { a, b, d, a, d, c });
+          }
+        }
+      }
+    }
+  }
+
+  float Area(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    float area = 0.0f;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+      Vector3 a = vertices[indices[i]].position, b = vertices[indices[i + 1]].position, c = vertices[indices[i + 2]].position;
+      area += glm::length(glm::cross(b - a, c - a)) * 0.5f;
+    }
+    return area;
+  }
+
+  // Edges used by other than two triangles once vertices are matched by position
+  size_t OpenEdges(const std::vector<V8_Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    auto key = [](const Vector3& p) { return std::array<float, 3> { p.x, p.y, p.z }; };
+
+    std::map<std::array<float, 3>, uint32_t> positionIds;
+    std::vector<uint32_t> ids(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+      ids[i] = positionIds.emplace(key(vertices[i].position), static_cast<uint32_t>(positionIds.size())).first->second;
+
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+      for (int e = 0; e < 3; e++) {
+        uint32_t a = ids[indices[i + e]], b = ids[indices[i + (e + 1) % 3]];
+        edges[{ std::min(a, b), std::max(a, b) }]++;
+      }
+    }
+
+    return std::count_if(edges.begin(), edges.end(), [](const auto& edge) { return edge.second != 2; });
+  }
+}
+
+TEST(Simplify, KeepsOpenBordersInPlace) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(16, vertices, indices);
+
+  std::vector<uint32_t> result = V8_SimplifyMesh(vertices, indices, 0, 1.0f);
+
+  EXPECT_LT(result.size(), indices.size());
+  EXPECT_NEAR(Area(vertices, result), 1.0f, 1e-4f);
+  EXPECT_EQ(OpenEdges(vertices, result), 4u * 16u);
+}
+
+TEST(Simplify, CollapsesAttributeSeamsWithoutOpeningThem) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildCube(8, vertices, indices);
+
+  std::vector<uint32_t> result = V8_SimplifyMesh(vertices, indices, 0, 0.01f);
+
+  EXPECT_LE(result.size() / 3, 48u);
+  EXPECT_EQ(OpenEdges(vertices, result), 0u);
+  EXPECT_NEAR(Area(vertices, result), 24.0f, 1e-3f);
+}
+
+TEST(Simplify, StopsAtTargetError) {
+  // Sphere, where every collapse costs something
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(32, vertices, indices);
+  for (V8_Vertex& vertex : vertices) {
+    float theta = vertex.position.y * 3.14159265f, phi = vertex.position.x * 2.0f * 3.14159265f;
+    vertex.position = Vector3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+  }
+
+  float error = -1.0f;
+  std::vector<uint32_t> result = V8_SimplifyMesh(vertices, indices, 0, 0.01f, &error);
+
+  EXPECT_LT(result.size(), indices.size());
+  EXPECT_GE(error, 0.0f);
+  EXPECT_LE(error, 0.01f);
+}
+
+TEST(Simplify, StopsAtTargetIndexCount) {
+  std::vector<V8_Vertex> vertices;
+  std::vector<uint32_t> indices;
+  BuildGrid(16, vertices, indices);
+
+  size_t target = indices.size() / 2;
+  std::vector<uint32_t> result = V8_SimplifyMesh(vertices, indices, target, 1.0f);
+
+  EXPECT_LE(result.size(), target);
+  EXPECT_GT(result.size(), target / 2);
+  for (uint32_t index : result)
+    EXPECT_LT(index, vertices.size());
+}
@@ -0,0 +1,104 @@
+#include <Core/Logger.h>
+
+#include <unordered_map>
+#include <fstream>
+#include <cstdio>
+#include <string>
+
+// Prints a binary log written by V8_Logger::OpenBinaryLog as text
+
+struct DecodedSite {
+  uint8_t level;
+  std::string format;
+  std::string funcName;
+};
+
+static const char* LevelName(uint8_t level) {
+  switch (static_cast<V8_Logger::LogLevel>(level)) {
+    case V8_Logger::LogLevel::Debug: return "DEBUG";
+    case V8_Logger::LogLevel::Info: return "INFO";
+    case V8_Logger::LogLevel::Warning: return "WARNING";
+    case V8_Logger::LogLevel::Error: return "ERROR";
+    case V8_Logger::LogLevel::Fatal: return "FATAL";
+    default: return "?";
+  }
+}
+
+template <typename T>
+static bool Read(std::ifstream& file, T& value) {
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static bool ReadString(std::ifstream& file, std::string& value) {
+  uint32_t length;
+  if (!Read(file, length))
+    return false;
+
+  value.resize(length);
+  return static_cast<bool>(file.read(value.data(), length));
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s <binary log>\n", argv[0]);
+    return 1;
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  uint32_t header[2];
+  if (!file.is_open() || !Read(file, header) || header[0] != V8_BINARY_LOG_MAGIC || header[1] != V8_BINARY_LOG_VERSION) {
+    std::fprintf(stderr, "%s is not a V8 binary log\n", argv[1]);
+    return 1;
+  }
+
+  std::unordered_map<uint32_t, DecodedSite> sites;
+  std::string payload;
+  std::string text;
+  std::string funcName;
+
+  V8_BinaryLogRecord type;
+  while (Read(file, type)) {
+    if (type == V8_BinaryLogRecord::Site) {
+      uint32_t id;
+      DecodedSite site;
+      if (!Read(file, id) || !Read(file, site.level) || !ReadString(file, site.format) || !ReadString(file, site.funcName))
+        break;
+
+      sites[id] = std::move(site);
+      continue;
+    }
+
+    if (type != V8_BinaryLogRecord::Message)
+      break;
+
+    uint32_t siteId;
+    uint8_t level, truncated;
+    if (!Read(file, siteId) || !Read(file, level) || !Read(file, truncated) || !ReadString(file, payload))
+      break;
+
+    if (siteId == 0) {
+      if (!ReadString(file, funcName))
+        break;
+
+      text = payload;
+    } else {
+      auto it = sites.find(siteId);
+      if (it == sites.end()) {
+        std::fprintf(stderr, "record references undefined site %u\n", siteId);
+        return 1;
+      }
+
+      V8_Logger::FormatDeferred(text, it->second.format, payload.data(), static_cast<uint32_t>(payload.size()));
+      funcName = it->second.funcName;
+    }
+
+    std::printf("[%s] %s%s (from: %s)\n", LevelName(level), text.c_str(), truncated ? "..." : "", funcName.c_str());
+  }
+
+  if (!file.eof()) {
+    std::fprintf(stderr, "%s is truncated or corrupt\n", argv[1]);
+    return 1;
+  }
+
+  return 0;
+}
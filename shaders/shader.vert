@@ -7,8 +7,12 @@ layout (location = 3) in vec2 uv;
 
 layout(location = 0) out vec3 fragColor;
 
+layout(push_constant) uniform DrawParams {
+    mat4 modelViewProjection;
+} draw;
+
 
 void main() {
-    gl_Position = vec4(position, 1.0);
+    gl_Position = draw.modelViewProjection * vec4(position, 1.0);
     fragColor = color;
 }